@@ -0,0 +1,95 @@
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include "arena.h"
+
+/**
+ * Konstruktor.
+ * Elöre nem foglal, az elsö blokk az elsö kéréskor készül.
+ *
+ * @param meret Egy blokk alapértelmezett mérete bájtban; a nagyobb kérések saját, akkora blokkot kapnak
+ */
+Arena::Arena(size_t meret) : aktualis(0), hely(0), blokk_meret(std::max(meret, (size_t)64)), upstream(0) {}
+
+/**
+ * Lefoglal egy igazított területet az arénából.
+ * Az aktuális blokk végéröl vesz, ha nem fér el, a következö már meglévö, elég nagy blokkra lép
+ * (reset vagy visszatekerés után ezek újra felhasználhatók), és csak ha ilyen nincs, kér új blokkot new[]-val.
+ * Egyenként nem szabadítható fel, csak reset-tel vagy egy Jelolo megszünésével egyszerre.
+ *
+ * @param meret A kért méret bájtban
+ * @param igazitas Az igazítás, 2 hatványa
+ * @return A terület elsö bájtja
+ */
+void* Arena::foglal(size_t meret, size_t igazitas) {
+    for (; aktualis < blokkok.size(); ++aktualis, hely = 0) {
+        Blokk& b = blokkok[aktualis];
+        size_t cim = (size_t)(reinterpret_cast<uintptr_t>(b.adat) + hely);
+        size_t eltolas = (igazitas - cim % igazitas) % igazitas;
+        if (hely + eltolas + meret <= b.meret) {
+            hely += eltolas + meret;
+            return b.adat + hely - meret;
+        }
+    }
+    Blokk uj;
+    uj.meret = std::max(blokk_meret, meret + igazitas);
+    uj.adat = new char[uj.meret];
+    upstream++;
+    blokkok.push_back(uj);
+    aktualis = blokkok.size() - 1;
+    size_t eltolas = (igazitas - reinterpret_cast<uintptr_t>(uj.adat) % igazitas) % igazitas;
+    hely = eltolas + meret;
+    return uj.adat + eltolas;
+}
+
+/**
+ * Az aréna minden foglalását egyszerre érvényteleníti, a blokkokat megtartja a következö foglalásokhoz.
+ */
+void Arena::reset() {
+    aktualis = 0;
+    hely = 0;
+}
+
+/**
+ * @return Hányszor kért az aréna memóriát a globális heapröl
+ */
+size_t Arena::upstream_foglalasok() const {
+    return upstream;
+}
+
+/**
+ * @return A blokkok összes mérete bájtban
+ */
+size_t Arena::kapacitas() const {
+    size_t osszes = 0;
+    for (const Blokk& b : blokkok)
+        osszes += b.meret;
+    return osszes;
+}
+
+/**
+ * Destruktor.
+ * Felszabadítja az összes blokkot.
+ */
+Arena::~Arena() {
+    for (Blokk& b : blokkok)
+        delete[] b.adat;
+}
+
+/**
+ * Megjegyzi az aréna aktuális állását.
+ *
+ * @param a Az aréna
+ */
+Arena::Jelolo::Jelolo(Arena& a) : arena(a), blokk(a.aktualis), hely(a.hely) {}
+
+/**
+ * Visszatekeri az arénát a létrehozáskori állására, így a közben történt foglalások helye újra felhasználható.
+ * A jelölöknek veremszerüen kell egymásba ágyazódniuk.
+ */
+Arena::Jelolo::~Jelolo() {
+    arena.aktualis = blokk;
+    arena.hely = hely;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <cstddef>
+
+#include "memtrace.h"
+
+class Arena {
+    struct Blokk {
+        char* adat;
+        size_t meret;
+    };
+    std::vector<Blokk> blokkok;
+    size_t aktualis;
+    size_t hely;
+    size_t blokk_meret;
+    size_t upstream;
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+public:
+    class Jelolo {
+        Arena& arena;
+        size_t blokk;
+        size_t hely;
+        Jelolo(const Jelolo&);
+        Jelolo& operator=(const Jelolo&);
+    public:
+        Jelolo(Arena&);
+        ~Jelolo();
+    };
+
+    Arena(size_t = (size_t)64 << 10);
+    void* foglal(size_t, size_t = alignof(std::max_align_t));
+    void reset();
+    size_t upstream_foglalasok() const;
+    size_t kapacitas() const;
+    ~Arena();
+};
+
+template <typename T>
+class ArenaAllocator {
+    template <typename U> friend class ArenaAllocator;
+    Arena* arena;
+public:
+    typedef T value_type;
+
+    ArenaAllocator(Arena& a) : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& rhs) : arena(rhs.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->foglal(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& rhs) const {
+        return arena == rhs.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& rhs) const {
+        return arena != rhs.arena;
+    }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+
+#endif // !ARENA_H
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include <string>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <vector>
+
+#include "benchmark.h"
+#include "suffix_array.h"
+#include "query_pool.h"
+#include "simd_compare.h"
+
+/**
+ * Ennyi másodperc fölött a lassabb algoritmust a nagyobb méreteken már nem mérjük.
+ */
+static const double IDOKORLAT = 60.0;
+
+/**
+ * Véletlen DNS jellegü szöveget generál (négy betüs ábécé).
+ *
+ * @param meret A szöveg hossza
+ * @return A generált szöveg
+ */
+static std::string dns_szoveg(size_t meret) {
+    static const char betuk[] = "ACGT";
+    std::mt19937 gen(42);
+    std::string str(meret, 'A');
+    for (size_t i = 0; i < meret; ++i)
+        str[i] = betuk[gen() % 4];
+    return str;
+}
+
+/**
+ * Log jellegü, erösen ismétlödö szöveget generál.
+ *
+ * @param meret A szöveg hossza
+ * @return A generált szöveg
+ */
+static std::string log_szoveg(size_t meret) {
+    std::mt19937 gen(42);
+    std::string str;
+    str.reserve(meret + 64);
+    while (str.length() < meret) {
+        str += "2021-05-01 12:00:00 INFO feldolgozva: ";
+        str += std::to_string(gen() % 1000);
+        str += '\n';
+    }
+    str.resize(meret);
+    return str;
+}
+
+/**
+ * Lemeri egy SuffixArray felépítésének idejét.
+ *
+ * @param str Az indexelendö szöveg
+ * @param algoritmus Az építés módja
+ * @param szalak A párhuzamos építés szálainak száma
+ * @return Az építés ideje másodpercben
+ */
+static double meres(const std::string& str, SuffixArray::Epites algoritmus, unsigned szalak = 0) {
+    std::chrono::steady_clock::time_point kezdet = std::chrono::steady_clock::now();
+    SuffixArray sa(str, algoritmus, szalak);
+    std::chrono::steady_clock::time_point vege = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(vege - kezdet).count();
+}
+
+/**
+ * Összeméri az SA-IS és az összehasonlító rendezéses építést 1 MB-tól max_mb-ig duplázódó méreteken.
+ * Ha a rendezés egy méreten túllépi az idökorlátot, a nagyobb méreteken kihagyja.
+ *
+ * @param os Ide írja az eredményeket
+ * @param max_mb A legnagyobb mért méret megabájtban
+ */
+void epites_benchmark(std::ostream& os, size_t max_mb) {
+    const char* nevek[] = { "dns", "log" };
+    for (int tipus = 0; tipus < 2; ++tipus) {
+        bool rendezes_kihagy = false;
+        os << "Szoveg: " << nevek[tipus] << '\n';
+        os << "meret(MB)\tSA-IS(s)\trendezes(s)\n";
+        for (size_t mb = 1; mb <= max_mb; mb *= 2) {
+            std::string str = tipus == 0 ? dns_szoveg(mb << 20) : log_szoveg(mb << 20);
+            os << mb << '\t' << meres(str, SuffixArray::SA_IS) << '\t';
+            if (rendezes_kihagy) {
+                os << "-\n";
+            } else {
+                double ido = meres(str, SuffixArray::RENDEZES);
+                rendezes_kihagy = ido > IDOKORLAT;
+                os << ido << '\n';
+            }
+            os.flush();
+        }
+    }
+}
+
+/**
+ * Lemeri a párhuzamos építést 1-töl max_szal-ig duplázódó szálszámmal, és kiírja a gyorsulást az egy szálhoz képest.
+ * Összehasonlításként az egyszálú SA-IS idejét is kiírja.
+ *
+ * @param os Ide írja az eredményeket
+ * @param mb A szöveg mérete megabájtban
+ * @param max_szal A legnagyobb mért szálszám, 0 esetén a processzormagok száma
+ */
+void parhuzamos_benchmark(std::ostream& os, size_t mb, unsigned max_szal) {
+    if (max_szal == 0)
+        max_szal = std::max(1u, std::thread::hardware_concurrency());
+    const char* nevek[] = { "dns", "log" };
+    for (int tipus = 0; tipus < 2; ++tipus) {
+        std::string str = tipus == 0 ? dns_szoveg(mb << 20) : log_szoveg(mb << 20);
+        os << "Szoveg: " << nevek[tipus] << ", " << mb << " MB, SA-IS: " << meres(str, SuffixArray::SA_IS) << " s\n";
+        os << "szalak\tido(s)\tgyorsulas\n";
+        double egy_szal = 0;
+        // kettö hatványai, és végül maga a max_szal
+        for (unsigned szalak = 1; szalak <= max_szal; szalak = (szalak < max_szal && szalak * 2 > max_szal) ? max_szal : szalak * 2) {
+            double ido = meres(str, SuffixArray::PARHUZAMOS, szalak);
+            if (szalak == 1)
+                egy_szal = ido;
+            os << szalak << '\t' << ido << '\t' << egy_szal / ido << '\n';
+            os.flush();
+        }
+    }
+}
+
+/**
+ * Összeméri a minták egyenkénti keresését (keres) a kötegelt kereséssel (keres_batch) és annak
+ * a processzormagok számának megfelelö szálon futó QueryPool változatával.
+ * A minták fele a szövegböl kivágott, fele véletlen karaktersorozat, 8-32 karakter hosszú.
+ *
+ * @param os Ide írja az eredményeket
+ * @param mb A szöveg mérete megabájtban
+ * @param minta_db A minták száma
+ */
+void kotegelt_kereses_benchmark(std::ostream& os, size_t mb, size_t minta_db) {
+    const char* nevek[] = { "dns", "log" };
+    for (int tipus = 0; tipus < 2; ++tipus) {
+        std::string str = tipus == 0 ? dns_szoveg(mb << 20) : log_szoveg(mb << 20);
+        SuffixArray sa(str);
+        std::mt19937 gen(7);
+        std::vector<std::string> mintak(minta_db);
+        for (size_t i = 0; i < minta_db; ++i) {
+            size_t hossz = 8 + gen() % 25;
+            if (i % 2 == 0) {
+                mintak[i] = str.substr(gen() % (str.length() - hossz), hossz);
+            } else {
+                for (size_t j = 0; j < hossz; ++j)
+                    mintak[i] += str[gen() % str.length()];
+            }
+        }
+
+        // a szálak indítása ne számítson bele a keresési idöbe
+        QueryPool pool;
+        std::chrono::steady_clock::time_point kezdet = std::chrono::steady_clock::now();
+        size_t talalt1 = 0;
+        for (const std::string& minta : mintak)
+            talalt1 += sa.keres(minta) != sa.end();
+        std::chrono::steady_clock::time_point kozep = std::chrono::steady_clock::now();
+        std::vector<SuffixArray::range> eredmeny = sa.keres_batch(mintak);
+        size_t talalt2 = 0;
+        for (const SuffixArray::range& r : eredmeny)
+            talalt2 += !r.empty();
+        std::chrono::steady_clock::time_point vege = std::chrono::steady_clock::now();
+        eredmeny = pool.keres(sa, mintak);
+        std::chrono::steady_clock::time_point pool_vege = std::chrono::steady_clock::now();
+
+        double egyenkent = std::chrono::duration<double>(kozep - kezdet).count();
+        double kotegelt = std::chrono::duration<double>(vege - kozep).count();
+        double parhuzamos = std::chrono::duration<double>(pool_vege - vege).count();
+        os << "Szoveg: " << nevek[tipus] << ", " << mb << " MB, " << minta_db << " minta, " << talalt1 << '/' << talalt2 << " talalt, osszehasonlitas: " << simd_nev(simd_szint()) << '\n';
+        os << "keres(s)\tkeres_batch(s)\tQueryPool " << pool.size() << " szal(s)\tgyorsulas\n";
+        os << egyenkent << '\t' << kotegelt << '\t' << parhuzamos << '\t' << egyenkent / kotegelt << " / " << egyenkent / parhuzamos << '\n';
+        os.flush();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "memtrace.h"
+
+#include <iostream>
+
+void epites_benchmark(std::ostream& os, size_t max_mb = 1024);
+void parhuzamos_benchmark(std::ostream& os, size_t mb = 256, unsigned max_szal = 0);
+void kotegelt_kereses_benchmark(std::ostream& os, size_t mb = 64, size_t minta_db = 1000000);
+
+#endif // !BENCHMARK_H
\ No newline at end of file
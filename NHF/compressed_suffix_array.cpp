@@ -0,0 +1,240 @@
+#include <string>
+#include <cstring>
+#include <stdexcept>
+
+#include "compressed_suffix_array.h"
+
+/**
+ * Iterátor konstruktor.
+ * A csa nullptr értéke jelenti az end() iterátort.
+ *
+ * @param c A bejárt CompressedSuffixArray
+ * @param f Az elsö illeszkedö sor
+ * @param l Az utolsó illeszkedö sor
+ */
+CompressedSuffixArray::iterator::iterator(const CompressedSuffixArray* c, size_t f, size_t l) : csa(c), first(f), last(l) {
+    frissit();
+}
+
+/**
+ * Az aktuális sor suffixére állítja a suffix nézetet.
+ * A suffix kezdöpozícióját a mintavételezett suffix tömbböl LF lépésekkel állítja elö.
+ */
+void CompressedSuffixArray::iterator::frissit() {
+    if (csa != nullptr) {
+        size_t pos = csa->fm.pozicio(first);
+        aktualis = SuffixArray::suffix_view(csa->szoveg.c_str() + pos, csa->szoveg.length() - pos);
+    } else {
+        aktualis = SuffixArray::suffix_view();
+    }
+}
+
+/**
+ * Pre inkremens operátor.
+ * Hibát dob, ha az end()-en túl próbálják növelni.
+ *
+ * @return A megnövelt iterátor
+ */
+CompressedSuffixArray::iterator& CompressedSuffixArray::iterator::operator++() {
+    if (csa == nullptr)
+        throw std::out_of_range("Tulindexeles");
+    if (first == last)
+        csa = nullptr, first = last = 0;
+    else
+        first++;
+    frissit();
+    return *this;
+}
+
+/**
+ * Post inkremens operátor.
+ * Hibát dob, ha az end()-en túl próbálják növelni.
+ *
+ * @return Az iterátor a növelés elött
+ */
+CompressedSuffixArray::iterator CompressedSuffixArray::iterator::operator++(int) {
+    iterator tmp(*this);
+    operator++();
+    return tmp;
+}
+
+/**
+ * Két iterátor egyenlöségét vizsgálja
+ *
+ * @return Egyenlö-e a két iterátor
+ */
+bool CompressedSuffixArray::iterator::operator==(const iterator& rhs) const {
+    return csa == rhs.csa && first == rhs.first && last == rhs.last;
+}
+
+/**
+ * Két iterátor nem egyenlöségét vizsgálja
+ *
+ * @return Nem egyenlö-e a két iterátor
+ */
+bool CompressedSuffixArray::iterator::operator!=(const iterator& rhs) const {
+    return !(*this == rhs);
+}
+
+/**
+ * Dereferáló operátor.
+ * Hibát dob, ha az iterátor egyenlö az end()-el.
+ *
+ * @return Az iterátor által mutatott suffix
+ */
+const SuffixArray::suffix_view& CompressedSuffixArray::iterator::operator*() const {
+    if (csa == nullptr)
+        throw std::out_of_range("Tulindexeles");
+    return aktualis;
+}
+
+/**
+ * Nyíl operátor.
+ * Hibát dob, ha az iterátor egyenlö az end()-el.
+ *
+ * @return A mutatott suffix nézet pointerje
+ */
+const SuffixArray::suffix_view* CompressedSuffixArray::iterator::operator->() const {
+    if (csa == nullptr)
+        throw std::out_of_range("Tulindexeles");
+    return &aktualis;
+}
+
+/**
+ * Konstruktor egy kész SuffixArray-böl.
+ * A teljes suffix tömb helyett csak minden lepes-edik szövegpozíció suffix tömb értékét (az FM-indexben)
+ * és inverz suffix tömb értékét tárolja, a többit LF lépésekkel állítja elö.
+ *
+ * @param sa A tömörítendö SuffixArray
+ * @param lepes A mintavételezés sürüsége, nagyobb érték kevesebb memóriát és lassabb elérést jelent
+ */
+CompressedSuffixArray::CompressedSuffixArray(const SuffixArray& sa, size_t lepes) : szoveg(sa.c_str(), sa.length()), fm(sa, lepes), lepes(lepes) {
+    size_t n = szoveg.length();
+    isa_minta.resize(n / lepes + 1);
+    for (size_t i = 0; i < n; ++i)
+        if (sa[i] % lepes == 0)
+            isa_minta[sa[i] / lepes] = i + 1;
+    if (n % lepes == 0)
+        isa_minta[n / lepes] = 0;
+}
+
+/**
+ * Konstruktor szövegböl.
+ * Felépíti a teljes suffix tömböt, majd tömöríti, így építés közben a teljes tömbnek is el kell férnie.
+ *
+ * @param str Az indexelendö szöveg
+ * @param lepes A mintavételezés sürüsége
+ */
+CompressedSuffixArray::CompressedSuffixArray(const std::string& str, size_t lepes) : CompressedSuffixArray(SuffixArray(str), lepes) {}
+
+/**
+ * @return A szöveg, és így a suffix tömb hossza
+ */
+size_t CompressedSuffixArray::length() const {
+    return szoveg.length();
+}
+
+/**
+ * @return A tárolt szöveg
+ */
+const char* CompressedSuffixArray::c_str() const {
+    return szoveg.c_str();
+}
+
+/**
+ * Vissza adja a suffix tömb egy elemét.
+ * Hibát dob, ha túlindexelnek.
+ *
+ * @param i Az index a suffix tömbben
+ * @return Az i. legkisebb suffix kezdöpozíciója a szövegben
+ */
+size_t CompressedSuffixArray::operator[](size_t i) const {
+    if (i >= szoveg.length())
+        throw std::out_of_range("Tulindexeles");
+    return fm.pozicio(i + 1);
+}
+
+/**
+ * Inverz suffix tömb: megadja, hányadik a suffix tömbben a pos-nál kezdödö suffix.
+ * A következö mintavételezett pozícióból indul, és LF lépésekkel halad visszafelé pos-ig.
+ * Hibát dob, ha túlindexelnek.
+ *
+ * @param pos A suffix kezdöpozíciója
+ * @return A suffix indexe a suffix tömbben
+ */
+size_t CompressedSuffixArray::rang(size_t pos) const {
+    size_t n = szoveg.length();
+    if (pos >= n)
+        throw std::out_of_range("Tulindexeles");
+    size_t minta_pos = (pos + lepes - 1) / lepes * lepes;
+    size_t sor;
+    if (minta_pos > n) {
+        minta_pos = n;
+        sor = 0;
+    } else {
+        sor = isa_minta[minta_pos / lepes];
+    }
+    for (; minta_pos > pos; --minta_pos)
+        sor = fm.lf(sor);
+    return sor - 1;
+}
+
+/**
+ * Megkeresi az összes karaktersorozatot, ami a kapott karakterrel kezdödik.
+ * Ha nincsen megfelelö talalat akkor az iterátor egyenlö lesz az end() értékkel.
+ *
+ * @param c A keresett karakter
+ * @return Egy iterátor a találatokkal
+ */
+CompressedSuffixArray::iterator CompressedSuffixArray::keres(const char c) const {
+    return keres(std::string_view(&c, 1));
+}
+
+/**
+ * Megkeresi az összes karaktersorozatot, ami a kapott karakterekkel kezdödik.
+ * Ha nincsen megfelelö talalat akkor az iterátor egyenlö lesz az end() értékkel.
+ *
+ * @param str A keresett karaktersorozat
+ * @return Egy iterátor a találatokkal
+ */
+CompressedSuffixArray::iterator CompressedSuffixArray::keres(const char* str) const {
+    return keres(std::string_view(str));
+}
+
+/**
+ * Megkeresi az összes karaktersorozatot, ami a kapott karakterekkel kezdödik.
+ * Ha nincsen megfelelö talalat akkor az iterátor egyenlö lesz az end() értékkel.
+ *
+ * @param str A keresett karaktersorozat
+ * @return Egy iterátor a találatokkal
+ */
+CompressedSuffixArray::iterator CompressedSuffixArray::keres(const std::string& str) const {
+    return keres(std::string_view(str));
+}
+
+/**
+ * Megkeresi az összes karaktersorozatot, ami a kapott karakterekkel kezdödik, az FM-index visszafelé keresésével.
+ * A mintát nem másolja. A találatok sorrendje ugyanaz, mint a SuffixArray::keres esetén.
+ * Ha nincsen megfelelö talalat akkor az iterátor egyenlö lesz az end() értékkel.
+ *
+ * @param str A keresett karaktersorozat
+ * @return Egy iterátor a találatokkal
+ */
+CompressedSuffixArray::iterator CompressedSuffixArray::keres(std::string_view str) const {
+    size_t eleje, vege;
+    if (szoveg.empty() || !fm.tartomany(str.data(), str.length(), eleje, vege))
+        return iterator();
+    // az üres minta a lezáró jel sorára is illeszkedne
+    if (str.empty())
+        eleje = 1;
+    return iterator(this, eleje, vege - 1);
+}
+
+/**
+ * Ad egy iterátort, ami minden iterátornak a végéül szolgál.
+ *
+ * @return Egy "nullptr" iterátor
+ */
+CompressedSuffixArray::iterator CompressedSuffixArray::end() const {
+    return iterator();
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef COMPRESSED_SUFFIX_ARRAY_H
+#define COMPRESSED_SUFFIX_ARRAY_H
+
+#include <vector>
+
+#include "memtrace.h"
+#include "suffix_array.h"
+#include "fm_index.h"
+
+class CompressedSuffixArray {
+    std::string szoveg;
+    FMIndex fm;
+    size_t lepes;
+    std::vector<size_t> isa_minta;
+public:
+    struct iterator {
+        const CompressedSuffixArray* csa;
+        size_t first;
+        size_t last;
+        SuffixArray::suffix_view aktualis;
+        void frissit();
+    public:
+        iterator(const CompressedSuffixArray* = nullptr, size_t = 0, size_t = 0);
+        iterator& operator++();
+        iterator operator++(int);
+        bool operator==(const iterator&) const;
+        bool operator!=(const iterator&) const;
+        const SuffixArray::suffix_view& operator*() const;
+        const SuffixArray::suffix_view* operator->() const;
+    };
+
+    CompressedSuffixArray(const SuffixArray&, size_t = 32);
+    CompressedSuffixArray(const std::string&, size_t = 32);
+    size_t length() const;
+    const char* c_str() const;
+    size_t operator[](size_t) const;
+    size_t rang(size_t) const;
+    iterator keres(const char) const;
+    iterator keres(const char*) const;
+    iterator keres(const std::string&) const;
+    iterator keres(std::string_view) const;
+    iterator end() const;
+};
+
+#endif // !COMPRESSED_SUFFIX_ARRAY_H
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+#include "document_collection.h"
+
+/**
+ * A dokumentumokat elválasztó karakter az összefüzött szövegben.
+ */
+static const char ELVALASZTO = '\0';
+
+/**
+ * Nem létezö sort jelöl.
+ */
+static const size_t NINCS = (size_t)-1;
+
+/**
+ * Az olyan mintáknál, amik üresek vagy tartalmazzák az elválasztót, a suffix tömb tartománya átnyúló
+ * vagy elválasztón kezdödö találatokat is tartalmazhat, ezeket egyenként kell ellenörizni.
+ */
+static bool ellenorizni_kell(const std::string& minta) {
+    return minta.empty() || minta.find(ELVALASZTO) != std::string::npos;
+}
+
+/**
+ * Elválasztókkal összefüzi a dokumentumokat.
+ *
+ * @param dokumentumok A dokumentumok
+ * @return Az összefüzött szöveg
+ */
+std::string DocumentCollection::osszefuz(const std::vector<std::string>& dokumentumok) {
+    std::string szoveg;
+    size_t meret = 0;
+    for (const std::string& dok : dokumentumok)
+        meret += dok.length() + 1;
+    szoveg.reserve(meret);
+    for (size_t d = 0; d < dokumentumok.size(); ++d) {
+        if (d > 0)
+            szoveg += ELVALASZTO;
+        szoveg += dokumentumok[d];
+    }
+    return szoveg;
+}
+
+/**
+ * Konstruktor.
+ * Egy általánosított suffix tömböt épít a dokumentumok elválasztókkal összefüzött szövegére, és mellé:
+ * - a dokumentum tömböt: a suffix tömb minden sorához a suffix dokumentumát (az elválasztókhoz a dokumentumok számát),
+ * - dokumentumonként a hozzá tartozó sorok rendezett listáját, amiböl a dokumentumonkénti darabszám
+ *   két bináris kereséssel megvan,
+ * - minden sorhoz az elözö, ugyanabba a dokumentumba tartozó sort és erre egy minimum keresö fát,
+ *   amivel a dokumentumok listázása a listázott dokumentumok számával arányos (Muthukrishnan algoritmusa).
+ *
+ * @param dokumentumok A dokumentumok
+ */
+DocumentCollection::DocumentCollection(const std::vector<std::string>& dokumentumok) : sa(osszefuz(dokumentumok)) {
+    size_t dok_db = dokumentumok.size();
+    if (dok_db >= UINT32_MAX)
+        throw std::invalid_argument("Tul sok dokumentum");
+    kezdetek.resize(dok_db + 1);
+    size_t pos = 0;
+    for (size_t d = 0; d < dok_db; ++d) {
+        kezdetek[d] = pos;
+        pos += dokumentumok[d].length() + 1;
+    }
+    kezdetek[dok_db] = pos;
+
+    size_t n = sa.length();
+    std::vector<uint32_t> pozicio_dok(n);
+    for (size_t d = 0; d < dok_db; ++d) {
+        std::fill(pozicio_dok.begin() + kezdetek[d], pozicio_dok.begin() + kezdetek[d] + hossz(d), (uint32_t)d);
+        if (d + 1 < dok_db)
+            pozicio_dok[kezdetek[d + 1] - 1] = (uint32_t)dok_db;
+    }
+    dok_tomb.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        dok_tomb[i] = pozicio_dok[sa[i]];
+
+    // a sorok dokumentumonként csoportosítva, a csoporton belül növekvöen (leszámláló rendezés)
+    dok_eleje.assign(dok_db + 2, 0);
+    for (size_t i = 0; i < n; ++i)
+        dok_eleje[dok_tomb[i] + 1]++;
+    for (size_t d = 0; d <= dok_db; ++d)
+        dok_eleje[d + 1] += dok_eleje[d];
+    dok_sorok.resize(n);
+    std::vector<size_t> hely(dok_eleje.begin(), dok_eleje.end() - 1);
+    for (size_t i = 0; i < n; ++i)
+        dok_sorok[hely[dok_tomb[i]]++] = i;
+
+    // elozo[i]: az i. sor elötti utolsó, ugyanabba a dokumentumba tartozó sor + 1, vagy 0, ha nincs ilyen;
+    // az elválasztók sorai soha ne kerüljenek listázásra
+    elozo.resize(n);
+    std::vector<size_t> utolso(dok_db, 0);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t d = dok_tomb[i];
+        if (d == dok_db) {
+            elozo[i] = NINCS;
+        } else {
+            elozo[i] = utolso[d];
+            utolso[d] = i + 1;
+        }
+    }
+
+    // alulról felfelé épített fa, a levelek az n..2n-1 indexeken, minden csúcsban a legkisebb elozo érték sora
+    min_fa.resize(2 * n);
+    for (size_t i = 0; i < n; ++i)
+        min_fa[n + i] = i;
+    for (size_t k = n; k-- > 1; ) {
+        size_t a = min_fa[2 * k], b = min_fa[2 * k + 1];
+        min_fa[k] = elozo[b] < elozo[a] ? b : a;
+    }
+}
+
+/**
+ * @param d A dokumentum sorszáma
+ * @return A dokumentum hossza
+ */
+size_t DocumentCollection::hossz(size_t d) const {
+    return kezdetek[d + 1] - kezdetek[d] - 1;
+}
+
+/**
+ * Megkeresi a mintával kezdödö suffixek sorainak [eleje, vege) tartományát a suffix tömbben.
+ */
+void DocumentCollection::sorok(const std::string& minta, size_t& eleje, size_t& vege) const {
+    size_t n = sa.length();
+    eleje = vege = 0;
+    if (n == 0)
+        return;
+    eleje = sa.hatar(minta.data(), minta.length(), 0, n, 0, false);
+    vege = sa.hatar(minta.data(), minta.length(), eleje, n, 0, true);
+}
+
+/**
+ * Megkeresi a [l, r) sorok közül a legkisebb elozo értékü sort a minimum keresö fában.
+ *
+ * @return A sor indexe
+ */
+size_t DocumentCollection::legkisebb(size_t l, size_t r) const {
+    size_t n = sa.length();
+    size_t legjobb = min_fa[n + l];
+    for (l += n, r += n; l < r; l /= 2, r /= 2) {
+        if (l % 2 == 1) {
+            size_t i = min_fa[l++];
+            if (elozo[i] < elozo[legjobb])
+                legjobb = i;
+        }
+        if (r % 2 == 1) {
+            size_t i = min_fa[--r];
+            if (elozo[i] < elozo[legjobb])
+                legjobb = i;
+        }
+    }
+    return legjobb;
+}
+
+/**
+ * Megszámolja, hány sor tartozik a d. dokumentumhoz a [eleje, vege) tartományban.
+ */
+size_t DocumentCollection::count(size_t d, size_t eleje, size_t vege) const {
+    const size_t* csoport = dok_sorok.data() + dok_eleje[d];
+    const size_t* csoport_vege = dok_sorok.data() + dok_eleje[d + 1];
+    return std::lower_bound(csoport, csoport_vege, vege) - std::lower_bound(csoport, csoport_vege, eleje);
+}
+
+/**
+ * @return A dokumentumok száma
+ */
+size_t DocumentCollection::size() const {
+    return kezdetek.size() - 1;
+}
+
+/**
+ * Megkeresi a minta összes elöfordulását a dokumentumokban.
+ * A találatok nem nyúlnak át dokumentumhatáron.
+ *
+ * @param minta A keresett karaktersorozat
+ * @return (dokumentum, pozíció a dokumentumban) párok, suffix tömb sorrendben
+ */
+std::vector<DocumentCollection::hit> DocumentCollection::keres(const std::string& minta) const {
+    std::vector<hit> talalatok;
+    size_t eleje, vege;
+    sorok(minta, eleje, vege);
+    talalatok.reserve(vege - eleje);
+    bool ellenoriz = ellenorizni_kell(minta);
+    for (size_t i = eleje; i < vege; ++i) {
+        size_t d = dok_tomb[i];
+        if (d == size())
+            continue;
+        size_t pos = sa[i] - kezdetek[d];
+        if (!ellenoriz || pos + minta.length() <= hossz(d))
+            talalatok.push_back(hit{ d, pos });
+    }
+    return talalatok;
+}
+
+/**
+ * Megszámolja a minta elöfordulásait az összes dokumentumban.
+ *
+ * @param minta A keresett karaktersorozat
+ * @return Az elöfordulások száma
+ */
+size_t DocumentCollection::count(const std::string& minta) const {
+    if (ellenorizni_kell(minta))
+        return keres(minta).size();
+    size_t eleje, vege;
+    sorok(minta, eleje, vege);
+    return vege - eleje;
+}
+
+/**
+ * Megszámolja a minta elöfordulásait egy dokumentumban, logaritmikus idöben.
+ * Hibát dob, ha nincs ilyen dokumentum.
+ *
+ * @param minta A keresett karaktersorozat
+ * @param d A dokumentum sorszáma
+ * @return Az elöfordulások száma a dokumentumban
+ */
+size_t DocumentCollection::count(const std::string& minta, size_t d) const {
+    if (d >= size())
+        throw std::out_of_range("Tulindexeles");
+    if (ellenorizni_kell(minta)) {
+        std::vector<hit> talalatok = keres(minta);
+        return std::count_if(talalatok.begin(), talalatok.end(), [d](const hit& h) { return h.dokumentum == d; });
+    }
+    size_t eleje, vege;
+    sorok(minta, eleje, vege);
+    return count(d, eleje, vege);
+}
+
+/**
+ * Felsorolja azokat a dokumentumokat, amikben a minta elöfordul.
+ * Egy dokumentum akkor kerül a listába, amikor a tartományban elöször fordul elö, vagyis az elözö sora a tartomány elött
+ * van; ezeket a minimum keresö fával keresi meg, így az idö a találatok helyett a dokumentumok számával arányos.
+ *
+ * @param minta A keresett karaktersorozat
+ * @return A dokumentumok sorszámai növekvö sorrendben
+ */
+std::vector<size_t> DocumentCollection::dokumentumok(const std::string& minta) const {
+    std::vector<size_t> lista;
+    if (ellenorizni_kell(minta)) {
+        for (const hit& h : keres(minta))
+            lista.push_back(h.dokumentum);
+        std::sort(lista.begin(), lista.end());
+        lista.erase(std::unique(lista.begin(), lista.end()), lista.end());
+        return lista;
+    }
+    size_t eleje, vege;
+    sorok(minta, eleje, vege);
+    std::vector<std::pair<size_t, size_t> > verem;
+    verem.push_back(std::make_pair(eleje, vege));
+    while (!verem.empty()) {
+        size_t l = verem.back().first, r = verem.back().second;
+        verem.pop_back();
+        if (l >= r)
+            continue;
+        size_t i = legkisebb(l, r);
+        if (elozo[i] > eleje)
+            continue;
+        lista.push_back(dok_tomb[i]);
+        verem.push_back(std::make_pair(l, i));
+        verem.push_back(std::make_pair(i + 1, r));
+    }
+    std::sort(lista.begin(), lista.end());
+    return lista;
+}
+
+/**
+ * Megadja azt a legfeljebb k dokumentumot, amikben a minta a legtöbbször fordul elö.
+ * Egyenlö gyakoriság esetén a kisebb sorszámú dokumentum van elöbb.
+ *
+ * @param minta A keresett karaktersorozat
+ * @param k A visszaadott dokumentumok legnagyobb száma
+ * @return (dokumentum, elöfordulások száma) párok csökkenö gyakoriság szerint
+ */
+std::vector<std::pair<size_t, size_t> > DocumentCollection::top_k(const std::string& minta, size_t k) const {
+    std::vector<std::pair<size_t, size_t> > eredmeny;
+    std::vector<size_t> lista = dokumentumok(minta);
+    eredmeny.reserve(lista.size());
+    if (ellenorizni_kell(minta)) {
+        for (size_t d : lista)
+            eredmeny.push_back(std::make_pair(d, count(minta, d)));
+    } else {
+        size_t eleje, vege;
+        sorok(minta, eleje, vege);
+        for (size_t d : lista)
+            eredmeny.push_back(std::make_pair(d, count(d, eleje, vege)));
+    }
+    k = std::min(k, eredmeny.size());
+    std::partial_sort(eredmeny.begin(), eredmeny.begin() + k, eredmeny.end(), [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    eredmeny.resize(k);
+    return eredmeny;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef DOCUMENT_COLLECTION_H
+#define DOCUMENT_COLLECTION_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+
+#include "memtrace.h"
+#include "suffix_array.h"
+
+class DocumentCollection {
+    std::vector<size_t> kezdetek;
+    SuffixArray sa;
+    std::vector<uint32_t> dok_tomb;
+    std::vector<size_t> dok_sorok;
+    std::vector<size_t> dok_eleje;
+    std::vector<size_t> elozo;
+    std::vector<size_t> min_fa;
+    static std::string osszefuz(const std::vector<std::string>&);
+    size_t hossz(size_t) const;
+    void sorok(const std::string&, size_t&, size_t&) const;
+    size_t legkisebb(size_t, size_t) const;
+    size_t count(size_t, size_t, size_t) const;
+public:
+    struct hit {
+        size_t dokumentum;
+        size_t pozicio;
+    };
+
+    DocumentCollection(const std::vector<std::string>&);
+    size_t size() const;
+    std::vector<hit> keres(const std::string&) const;
+    size_t count(const std::string&) const;
+    size_t count(const std::string&, size_t) const;
+    std::vector<size_t> dokumentumok(const std::string&) const;
+    std::vector<std::pair<size_t, size_t> > top_k(const std::string&, size_t) const;
+};
+
+#endif // !DOCUMENT_COLLECTION_H
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <string>
+#include <cstring>
+#include <vector>
+#include <functional>
+#include <utility>
+
+#include "driver.h"
+#include "suffix_array.h"
+#include "mapped_file.h"
+#include "index_format.h"
+
+/**
+ * Ekkora kimeneti puffer telik meg, mielött a kimenetre írunk.
+ */
+static const size_t PUFFER_MERET = (size_t)1 << 20;
+
+/**
+ * Decimálisan a puffer végére írja a számot.
+ *
+ * @param puffer A kimeneti puffer
+ * @param x A kiírandó szám
+ */
+static void szam_ir(std::string& puffer, size_t x) {
+    char jegyek[24];
+    size_t i = sizeof(jegyek);
+    do {
+        jegyek[--i] = (char)('0' + x % 10);
+        x /= 10;
+    } while (x != 0);
+    puffer.append(jegyek + i, sizeof(jegyek) - i);
+}
+
+/**
+ * Indexeli a fájlt, és soronként egy mintát olvasva megválaszolja a lekérdezéseket.
+ * Ha a fájl SuffixArray::save-vel készült index, leképezve nyitja meg, különben a fájl
+ * leképezett tartalmát egyszer átmásolja, lezárja a leképezést, és a másolatot átadva épít indexet,
+ * így a szövegböl az építés alatt csak egy példány van a memóriában.
+ * Mintánként egy sort ír: a mintát, a találatok számát és a kezdöpozíciókat szövegbeli sorrendben,
+ * tabulátorokkal elválasztva. Az üres sorokat kihagyja, a sorvégi '\r'-t levágja.
+ * A kimenetet nagy pufferben gyüjti, és csak a puffer megtelésekor, illetve a végén írja ki,
+ * így nagy találathalmazoknál sem soronkénti ürítés szabja meg a sebességet.
+ * A találatok lekérdezésenként újrakezdett arénába kerülnek, így a bemelegedés után a keresések
+ * nem foglalnak a globális heapröl.
+ * Hibát dob, ha a fájl nem nyitható meg vagy üres.
+ *
+ * @param fajl Az indexelendö szövegfájl vagy elmentett index
+ * @param lekerdezesek Innen olvassa a mintákat, soronként egyet
+ * @param os Ide írja a találatokat
+ */
+void fajl_kereses(const char* fajl, std::istream& lekerdezesek, std::ostream& os) {
+    std::string tartalom;
+    bool index;
+    {
+        MappedFile forras(fajl);
+        index = forras.size() >= sizeof(IndexFejlec) && std::memcmp(forras.data(), INDEX_AZONOSITO, sizeof(INDEX_AZONOSITO)) == 0;
+        if (!index)
+            tartalom.assign(forras.data(), forras.size());
+    }
+    SuffixArray sa = index ? SuffixArray::open(fajl) : SuffixArray(std::move(tartalom));
+
+    std::string puffer;
+    puffer.reserve(PUFFER_MERET + 4096);
+    std::string minta;
+    Arena arena;
+    while (std::getline(lekerdezesek, minta)) {
+        if (!minta.empty() && minta[minta.length() - 1] == '\r')
+            minta.erase(minta.length() - 1);
+        if (minta.empty())
+            continue;
+        arena.reset();
+        ArenaVector<size_t> talalatok = sa.locate(minta, arena, true);
+        puffer += minta;
+        puffer += '\t';
+        szam_ir(puffer, talalatok.size());
+        puffer += '\t';
+        for (size_t i = 0; i < talalatok.size(); ++i) {
+            if (i != 0)
+                puffer += ' ';
+            szam_ir(puffer, talalatok[i]);
+            if (puffer.length() >= PUFFER_MERET) {
+                os.write(puffer.data(), puffer.length());
+                puffer.clear();
+            }
+        }
+        puffer += '\n';
+        if (puffer.length() >= PUFFER_MERET) {
+            os.write(puffer.data(), puffer.length());
+            puffer.clear();
+        }
+    }
+    os.write(puffer.data(), puffer.length());
+    os.flush();
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef DRIVER_H
+#define DRIVER_H
+
+#include "memtrace.h"
+
+#include <iostream>
+
+void fajl_kereses(const char* fajl, std::istream& lekerdezesek, std::ostream& os);
+
+#endif // !DRIVER_H
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <queue>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+
+#include "external_builder.h"
+#include "mapped_file.h"
+#include "index_format.h"
+#include "simd_compare.h"
+
+/**
+ * A futamok olvasásához és a kimenet írásához használt puffer legkisebb mérete elemekben.
+ */
+static const size_t MIN_PUFFER = 1024;
+
+/**
+ * Egy összefésülésben egyszerre nyitva tartott futamok legnagyobb száma, hogy a fájlleírók ne fogyjanak el.
+ */
+static const size_t MAX_FOK = 256;
+
+/**
+ * Egy suffix a rendezéshez: a kezdöpozíciója és az elsö 8 bájtja nagy végü számként,
+ * a szöveg végén túl nullákkal kiegészítve. Két suffix kulcsainak sorrendje megegyezik
+ * a suffixekével, ha a kulcsok különböznek, így a szöveghez csak egyezö kulcsnál kell nyúlni.
+ * A futamfájlok is ilyen elemekböl állnak, hogy az összefésülés is a kulcsokkal dolgozhasson.
+ */
+struct KulcsosSuffix {
+    uint64_t kulcs;
+    size_t pos;
+
+    bool operator<(const KulcsosSuffix& rhs) const {
+        return kulcs < rhs.kulcs || (kulcs == rhs.kulcs && pos < rhs.pos);
+    }
+};
+
+/**
+ * Egy rendezett futam pufferelt olvasója.
+ */
+struct Futam {
+    std::ifstream fajl;
+    std::vector<KulcsosSuffix> puffer;
+    size_t hely;
+    size_t db;
+
+    Futam(const std::string& nev, size_t meret) : fajl(nev.c_str(), std::ios::binary), puffer(meret), hely(0), db(0) {
+        if (!fajl)
+            throw std::runtime_error("Nem nyithato meg: " + nev);
+    }
+
+    /**
+     * Kiolvassa a futam következö elemét.
+     *
+     * @param elem Ide kerül az elem
+     * @return Volt-e még elem
+     */
+    bool kovetkezo(KulcsosSuffix& elem) {
+        if (hely == db) {
+            fajl.read(reinterpret_cast<char*>(puffer.data()), puffer.size() * sizeof(KulcsosSuffix));
+            db = (size_t)fajl.gcount() / sizeof(KulcsosSuffix);
+            hely = 0;
+            if (db == 0)
+                return false;
+        }
+        elem = puffer[hely++];
+        return true;
+    }
+};
+
+/**
+ * Az összefésülés kupacának eleme: a futam soron következö suffixe és a futam indexe.
+ */
+struct KupacElem {
+    KulcsosSuffix suffix;
+    size_t futam;
+};
+
+/**
+ * Az összefésülés kupacának rendezése: a legkisebb suffix kerüljön a tetejére.
+ * A szöveget csak egyezö kulcsnál olvassa.
+ */
+struct KupacRendezes {
+    const char* szoveg;
+    size_t n;
+
+    bool operator()(const KupacElem& a, const KupacElem& b) const {
+        if (a.suffix.kulcs != b.suffix.kulcs)
+            return b.suffix.kulcs < a.suffix.kulcs;
+        return suffix_kisebb(szoveg, n, b.suffix.pos, a.suffix.pos);
+    }
+};
+
+/**
+ * Törli az ideiglenes fájlokat, akkor is, ha az építés hibával áll le.
+ */
+struct IdeiglenesFajlok {
+    std::vector<std::string> nevek;
+
+    ~IdeiglenesFajlok() {
+        for (const std::string& nev : nevek)
+            std::remove(nev.c_str());
+    }
+};
+
+/**
+ * Kiírja az összefésülés kimeneti pufferét, majd kiüríti.
+ *
+ * @param ki Ide ír
+ * @param kimeno A kiírandó suffixek
+ * @param poziciok Segédpuffer a csak pozíciós kiíráshoz
+ * @param csak_pozicio Igaz, ha a kimenet a végsö suffix tömb, hamis, ha újabb futam (kulcsokkal együtt)
+ */
+static void puffer_kiir(std::ostream& ki, std::vector<KulcsosSuffix>& kimeno, std::vector<size_t>& poziciok, bool csak_pozicio) {
+    if (csak_pozicio) {
+        poziciok.clear();
+        for (const KulcsosSuffix& elem : kimeno)
+            poziciok.push_back(elem.pos);
+        ki.write(reinterpret_cast<const char*>(poziciok.data()), poziciok.size() * sizeof(size_t));
+    } else {
+        ki.write(reinterpret_cast<const char*>(kimeno.data()), kimeno.size() * sizeof(KulcsosSuffix));
+    }
+    kimeno.clear();
+}
+
+/**
+ * Kupaccal összefésüli a nevek [eleje, vege) futamait.
+ * A kupac a kulcsokat hasonlítja, a szöveget csak egyezö kulcsnál olvassa.
+ *
+ * @param nevek A futamfájlok nevei
+ * @param eleje Az elsö összefésülendö futam indexe
+ * @param vege Az utolsó utáni futam indexe
+ * @param szoveg A szöveg
+ * @param n A szöveg hossza
+ * @param puffer Futamonkénti és kimeneti pufferméret elemekben
+ * @param ki Ide ír
+ * @param csak_pozicio Igaz, ha a kimenet a végsö suffix tömb, hamis, ha újabb futam (kulcsokkal együtt)
+ */
+static void osszefesul(const std::vector<std::string>& nevek, size_t eleje, size_t vege, const char* szoveg, size_t n,
+                       size_t puffer, std::ostream& ki, bool csak_pozicio) {
+    std::vector<Futam> futamok;
+    futamok.reserve(vege - eleje);
+    KupacRendezes rendezes = { szoveg, n };
+    std::priority_queue<KupacElem, std::vector<KupacElem>, KupacRendezes> kupac(rendezes);
+    for (size_t b = eleje; b < vege; ++b) {
+        futamok.emplace_back(nevek[b], puffer);
+        KupacElem elem;
+        elem.futam = b - eleje;
+        if (futamok.back().kovetkezo(elem.suffix))
+            kupac.push(elem);
+    }
+    std::vector<KulcsosSuffix> kimeno;
+    std::vector<size_t> poziciok;
+    kimeno.reserve(puffer);
+    while (!kupac.empty()) {
+        KupacElem legkisebb = kupac.top();
+        kupac.pop();
+        kimeno.push_back(legkisebb.suffix);
+        if (kimeno.size() == puffer)
+            puffer_kiir(ki, kimeno, poziciok, csak_pozicio);
+        if (futamok[legkisebb.futam].kovetkezo(legkisebb.suffix))
+            kupac.push(legkisebb);
+    }
+    puffer_kiir(ki, kimeno, poziciok, csak_pozicio);
+}
+
+/**
+ * Konstruktor.
+ *
+ * @param memoria_korlat Az építés által használható memória bájtban, a leképezett bemeneten felül
+ */
+ExternalBuilder::ExternalBuilder(size_t memoria_korlat) : memoria(memoria_korlat) {}
+
+/**
+ * @return Egy blokkban egyszerre rendezett suffixek száma; suffixenként egy kulcs-pozíció pár fér a korlátba
+ */
+size_t ExternalBuilder::blokk_meret() const {
+    return std::max((size_t)1, memoria / sizeof(KulcsosSuffix));
+}
+
+/**
+ * Külsö memóriás építés: a bemeneti fájl szövegéböl a SuffixArray::open által megnyitható indexet készít
+ * úgy, hogy a suffix tömb sosem kerül egészében a memóriába.
+ * A bemenetet csak olvasásra leképezi, így azt az operációs rendszer lapozza, nem a memóriakorlátba számít.
+ * Elöször blokk_meret() suffixenként rendez: a suffixeket az elsö 8 bájtjuk szerint, az egyezö kulcsúakat
+ * a teljes suffix szerint, és minden blokkot a kulcsokkal együtt ideiglenes futamfájlba ír. Ezután a futamokat
+ * kupaccal, pufferelt olvasással fésüli össze. Egy menetben legfeljebb annyi futamot fésül össze, amennyinek
+ * MIN_PUFFER méretü puffere a memóriakorlátba fér (de legalább kettöt, és legfeljebb MAX_FOK-ot, a fájlleírók miatt);
+ * ha több futam van, a közbülsö menetek újabb, hosszabb futamokat írnak, és csak az utolsó ír a kimenet suffix tömb szakaszába.
+ * A kulcsokat a blokk sorban olvasott szövegéböl gördülve számolja, a rendezés és az összefésülés pedig a kulcsokat
+ * hasonlítja; a leképezett szöveget csak az azonos 8 bájttal kezdödö suffixeknél olvassa tetszöleges helyen.
+ * Ez a futamfájlokat kétszer akkorává teszi, de a sok ismétlödés nélküli szövegen az összefésülés nem lapoz a bemenetben.
+ * Egyetlen blokk esetén nincs ideiglenes fájl. LCP tömb nem készül, az ideiglenes fájlok a kimenet mellé kerülnek.
+ * Hibát dob, ha a bemenet üres vagy nem olvasható, illetve ha a kimenet vagy egy ideiglenes fájl nem írható.
+ *
+ * @param bemenet Az indexelendö szöveget tartalmazó fájl
+ * @param kimenet Az elkészülö index fájl
+ */
+void ExternalBuilder::build(const char* bemenet, const char* kimenet) const {
+    MappedFile forras(bemenet);
+    const char* szoveg = forras.data();
+    size_t n = forras.size();
+    size_t blokk = std::min(blokk_meret(), n);
+    size_t blokk_db = (n + blokk - 1) / blokk;
+
+    IdeiglenesFajlok ideiglenes;
+    std::ofstream cel(kimenet, std::ios::binary | std::ios::trunc);
+    if (!cel)
+        throw std::runtime_error(std::string("Nem irhato: ") + kimenet);
+    IndexFejlec fejlec = index_fejlec(n, false);
+    const char nullak[8] = { 0 };
+    cel.write(reinterpret_cast<const char*>(&fejlec), sizeof(fejlec));
+    cel.write(nullak, fejlec.szoveg_eleje - sizeof(fejlec));
+    cel.write(szoveg, n);
+    cel.write(nullak, fejlec.suffix_eleje - fejlec.szoveg_eleje - n);
+
+    // blokkonkénti rendezés
+    {
+        std::vector<KulcsosSuffix> kulcsok(blokk);
+        for (size_t b = 0; b < blokk_db; ++b) {
+            size_t eleje = b * blokk, db = std::min(blokk, n - eleje);
+            uint64_t k = 0;
+            for (size_t i = 0; i < 7; ++i)
+                k = k << 8 | (eleje + i < n ? (unsigned char)szoveg[eleje + i] : 0);
+            for (size_t i = 0; i < db; ++i) {
+                k = k << 8 | (eleje + i + 7 < n ? (unsigned char)szoveg[eleje + i + 7] : 0);
+                kulcsok[i].kulcs = k;
+                kulcsok[i].pos = eleje + i;
+            }
+            std::sort(kulcsok.begin(), kulcsok.begin() + db);
+            for (size_t i = 0, j; i < db; i = j) {
+                for (j = i + 1; j < db && kulcsok[j].kulcs == kulcsok[i].kulcs; ++j);
+                if (j - i > 1)
+                    std::sort(kulcsok.begin() + i, kulcsok.begin() + j, [szoveg, n](const KulcsosSuffix& a, const KulcsosSuffix& c) {
+                        return suffix_kisebb(szoveg, n, a.pos, c.pos);
+                    });
+            }
+            if (blokk_db == 1) {
+                std::vector<size_t> kimeno;
+                kimeno.reserve(MIN_PUFFER);
+                for (size_t i = 0; i < db; ++i) {
+                    kimeno.push_back(kulcsok[i].pos);
+                    if (kimeno.size() == MIN_PUFFER || i + 1 == db) {
+                        cel.write(reinterpret_cast<const char*>(kimeno.data()), kimeno.size() * sizeof(size_t));
+                        kimeno.clear();
+                    }
+                }
+                break;
+            }
+            ideiglenes.nevek.push_back(std::string(kimenet) + ".futam" + std::to_string(b));
+            std::ofstream futam(ideiglenes.nevek.back().c_str(), std::ios::binary | std::ios::trunc);
+            futam.write(reinterpret_cast<const char*>(kulcsok.data()), db * sizeof(KulcsosSuffix));
+            if (!futam)
+                throw std::runtime_error("Nem irhato: " + ideiglenes.nevek.back());
+        }
+    }
+
+    // a futamok összefésülése
+    if (blokk_db > 1) {
+        // a futamok és a kimenet pufferei együtt férjenek a korlátba
+        size_t fok = memoria / (MIN_PUFFER * sizeof(KulcsosSuffix));
+        fok = std::min(MAX_FOK, std::max((size_t)2, fok > 0 ? fok - 1 : 0));
+        std::vector<std::string> futamok = ideiglenes.nevek;
+        while (futamok.size() > fok) {
+            std::vector<std::string> kovetkezo;
+            for (size_t i = 0; i < futamok.size(); i += fok) {
+                size_t vege = std::min(futamok.size(), i + fok);
+                if (vege - i == 1) {
+                    kovetkezo.push_back(futamok[i]);
+                    continue;
+                }
+                ideiglenes.nevek.push_back(std::string(kimenet) + ".futam" + std::to_string(ideiglenes.nevek.size()));
+                {
+                    std::ofstream futam(ideiglenes.nevek.back().c_str(), std::ios::binary | std::ios::trunc);
+                    osszefesul(futamok, i, vege, szoveg, n, std::max(MIN_PUFFER, memoria / sizeof(KulcsosSuffix) / (vege - i + 1)), futam, false);
+                    if (!futam)
+                        throw std::runtime_error("Nem irhato: " + ideiglenes.nevek.back());
+                }
+                // a beolvasott futamok helye azonnal felszabadul
+                for (size_t j = i; j < vege; ++j)
+                    std::remove(futamok[j].c_str());
+                kovetkezo.push_back(ideiglenes.nevek.back());
+            }
+            futamok.swap(kovetkezo);
+        }
+        osszefesul(futamok, 0, futamok.size(), szoveg, n, std::max(MIN_PUFFER, memoria / sizeof(KulcsosSuffix) / (futamok.size() + 1)), cel, true);
+    }
+    if (!cel)
+        throw std::runtime_error(std::string("Hiba iras kozben: ") + kimenet);
+}
+
+/**
+ * Külsö memóriás építés std::string útvonalakkal.
+ *
+ * @param bemenet Az indexelendö szöveget tartalmazó fájl
+ * @param kimenet Az elkészülö index fájl
+ */
+void ExternalBuilder::build(const std::string& bemenet, const std::string& kimenet) const {
+    build(bemenet.c_str(), kimenet.c_str());
+}
\ No newline at end of file
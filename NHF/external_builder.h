@@ -0,0 +1,19 @@
+#ifndef EXTERNAL_BUILDER_H
+#define EXTERNAL_BUILDER_H
+
+#include <string>
+
+#include "memtrace.h"
+
+class ExternalBuilder {
+    size_t memoria;
+    ExternalBuilder(const ExternalBuilder&);
+    ExternalBuilder& operator=(const ExternalBuilder&);
+public:
+    ExternalBuilder(size_t = (size_t)256 << 20);
+    size_t blokk_meret() const;
+    void build(const char*, const char*) const;
+    void build(const std::string&, const std::string&) const;
+};
+
+#endif // !EXTERNAL_BUILDER_H
\ No newline at end of file
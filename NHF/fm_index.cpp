@@ -0,0 +1,257 @@
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <bitset>
+
+#include "fm_index.h"
+
+/**
+ * Megszámolja az egyes biteket egy 64 bites szóban.
+ */
+static size_t bitszam(uint64_t x) {
+    return std::bitset<64>(x).count();
+}
+
+/**
+ * FM-index konstruktor.
+ * A SuffixArray-böl felépíti a Burrows-Wheeler transzformáltat, a C táblát, a mintavételezett
+ * elöfordulás (rang) táblát és a mintavételezett suffix tömböt. A szövegre utána nincs szükség.
+ * A szöveg végére egy virtuális, mindennél kisebb lezáró jelet képzelünk, ennek a sora vege_sor.
+ *
+ * @param sa A SuffixArray, amiböl az index készül
+ * @param sa_lepes Minden ennyiedik szövegpozícióhoz tárolja a suffix tömb értékét (locate sebesség/memória)
+ * @param occ_lepes Ennyi soronként tárolja az elöfordulások számát (count sebesség/memória)
+ */
+FMIndex::FMIndex(const SuffixArray& sa, size_t sa_lepes, size_t occ_lepes) : n(sa.length()), bwt(sa.length() + 1, '\0'), vege_sor(0), abc_meret(0), occ_lepes(occ_lepes), sa_lepes(sa_lepes) {
+    if (sa_lepes == 0 || occ_lepes == 0 || occ_lepes > 65536)
+        throw std::invalid_argument("Hibas mintavetelezesi lepes");
+    const unsigned char* szoveg = reinterpret_cast<const unsigned char*>(sa.c_str());
+
+    // C tábla és az ábécé: a lezáró jel mindennél kisebb, ezért minden C érték legalább 1
+    size_t darab[256] = { 0 };
+    for (size_t i = 0; i < n; ++i)
+        darab[szoveg[i]]++;
+    C[0] = 1;
+    for (int c = 0; c < 256; ++c) {
+        C[c + 1] = C[c] + darab[c];
+        kod[c] = darab[c] > 0 ? (short)abc_meret++ : -1;
+    }
+
+    // BWT és a mintavételezett suffix tömb; a 0. sor a lezáró jelhez tartozó üres suffix
+    jeloles.assign((n + 1) / 64 + 1, 0);
+    for (size_t sor = 0; sor <= n; ++sor) {
+        size_t pos = sor == 0 ? n : sa[sor - 1];
+        if (pos == 0)
+            vege_sor = sor;
+        else
+            bwt[sor] = (char)szoveg[pos - 1];
+        if (pos % sa_lepes == 0)
+            jeloles[sor / 64] |= (uint64_t)1 << (sor % 64);
+    }
+    jeloles_rang.resize(jeloles.size());
+    size_t osszes = 0;
+    for (size_t i = 0; i < jeloles.size(); ++i) {
+        jeloles_rang[i] = osszes;
+        osszes += bitszam(jeloles[i]);
+    }
+    sa_minta.reserve(osszes);
+    for (size_t sor = 0; sor <= n; ++sor) {
+        size_t pos = sor == 0 ? n : sa[sor - 1];
+        if (pos % sa_lepes == 0)
+            sa_minta.push_back(pos);
+    }
+
+    // elöfordulási tábla: szuperblokkonként abszolút, blokkonként a szuperblokkhoz relatív számok
+    szuper_lepes = 65536 / occ_lepes * occ_lepes;
+    occ_szuper.reserve(((n + 1) / szuper_lepes + 1) * abc_meret);
+    occ_blokk.reserve(((n + 1) / occ_lepes + 1) * abc_meret);
+    std::vector<size_t> szamlalo(abc_meret, 0), szuper(abc_meret, 0);
+    for (size_t sor = 0; sor <= n + 1; ++sor) {
+        if (sor % szuper_lepes == 0) {
+            szuper = szamlalo;
+            occ_szuper.insert(occ_szuper.end(), szamlalo.begin(), szamlalo.end());
+        }
+        if (sor % occ_lepes == 0)
+            for (size_t k = 0; k < abc_meret; ++k)
+                occ_blokk.push_back((unsigned short)(szamlalo[k] - szuper[k]));
+        if (sor <= n && sor != vege_sor)
+            szamlalo[kod[(unsigned char)bwt[sor]]]++;
+    }
+}
+
+/**
+ * Megszámolja a c karakter elöfordulásait a BWT elsö i sorában.
+ *
+ * @param c A keresett karakter, aminek szerepelnie kell a szövegben
+ * @param i A vizsgált sorok száma
+ * @return Az elöfordulások száma
+ */
+size_t FMIndex::occ(unsigned char c, size_t i) const {
+    size_t k = (size_t)kod[c];
+    size_t blokk = i / occ_lepes;
+    size_t eredmeny = occ_szuper[i / szuper_lepes * abc_meret + k] + occ_blokk[blokk * abc_meret + k];
+    size_t kezdet = blokk * occ_lepes;
+    for (size_t j = kezdet; j < i; ++j)
+        if ((unsigned char)bwt[j] == c)
+            eredmeny++;
+    // a lezáró jel helyén álló 0 bájt nem számít
+    if (c == 0 && kezdet <= vege_sor && vege_sor < i)
+        eredmeny--;
+    return eredmeny;
+}
+
+/**
+ * LF leképezés: a sorhoz tartozó suffix elé egy karaktert téve kapott suffix sora.
+ *
+ * @param sor Egy sor, ami nem a lezáró jel sora
+ * @return Az egy pozícióval korábban kezdödö suffix sora
+ */
+size_t FMIndex::lf(size_t sor) const {
+    unsigned char c = (unsigned char)bwt[sor];
+    return C[c] + occ(c, sor);
+}
+
+/**
+ * Visszaadja egy sor suffixének kezdöpozícióját a szövegben.
+ * Addig lép az LF leképezéssel visszafelé, amíg mintavételezett sorhoz nem ér.
+ *
+ * @param sor A sor indexe
+ * @return A suffix kezdöpozíciója
+ */
+size_t FMIndex::pozicio(size_t sor) const {
+    size_t lepes = 0;
+    while (!((jeloles[sor / 64] >> (sor % 64)) & 1)) {
+        sor = lf(sor);
+        lepes++;
+    }
+    uint64_t maszk = ((uint64_t)1 << (sor % 64)) - 1;
+    return sa_minta[jeloles_rang[sor / 64] + bitszam(jeloles[sor / 64] & maszk)] + lepes;
+}
+
+/**
+ * Visszafelé keresés: megkeresi a mintával kezdödö suffixek sorainak tartományát.
+ *
+ * @param minta A keresett minta
+ * @param m A minta hossza
+ * @param eleje Az elsö illeszkedö sor
+ * @param vege Az utolsó illeszkedö sor utáni sor
+ * @return Van-e találat
+ */
+bool FMIndex::tartomany(const char* minta, size_t m, size_t& eleje, size_t& vege) const {
+    eleje = 0;
+    vege = n + 1;
+    for (size_t i = m; i-- > 0 && eleje < vege; ) {
+        unsigned char c = (unsigned char)minta[i];
+        if (kod[c] < 0)
+            return false;
+        eleje = C[c] + occ(c, eleje);
+        vege = C[c] + occ(c, vege);
+    }
+    return eleje < vege;
+}
+
+/**
+ * @return Az indexelt szöveg hossza
+ */
+size_t FMIndex::length() const {
+    return n;
+}
+
+/**
+ * Megszámolja a karakter elöfordulásait a szövegben.
+ *
+ * @param c A keresett karakter
+ * @return Az elöfordulások száma
+ */
+size_t FMIndex::count(const char c) const {
+    return C[(unsigned char)c + 1] - C[(unsigned char)c];
+}
+
+/**
+ * Megszámolja a minta elöfordulásait a szövegben, a szöveg használata nélkül.
+ * Az üres minta minden pozíción elöfordul.
+ *
+ * @param minta A keresett minta
+ * @param m A minta hossza
+ * @return Az elöfordulások száma
+ */
+size_t FMIndex::count(const char* minta, size_t m) const {
+    size_t eleje, vege;
+    if (m == 0)
+        return n;
+    if (!tartomany(minta, m, eleje, vege))
+        return 0;
+    return vege - eleje;
+}
+
+/**
+ * Megszámolja a karaktersorozat elöfordulásait a szövegben.
+ *
+ * @param str A keresett karaktersorozat
+ * @return Az elöfordulások száma
+ */
+size_t FMIndex::count(const char* str) const {
+    return count(str, std::strlen(str));
+}
+
+/**
+ * Megszámolja a karaktersorozat elöfordulásait a szövegben.
+ *
+ * @param str A keresett karaktersorozat
+ * @return Az elöfordulások száma
+ */
+size_t FMIndex::count(const std::string& str) const {
+    return count(str.data(), str.length());
+}
+
+/**
+ * Megkeresi a minta összes elöfordulásának kezdöpozícióját.
+ * Az üres minta minden pozíción elöfordul.
+ *
+ * @param minta A keresett minta
+ * @param m A minta hossza
+ * @return A kezdöpozíciók a suffix tömb sorrendjében
+ */
+std::vector<size_t> FMIndex::locate(const char* minta, size_t m) const {
+    std::vector<size_t> talalatok;
+    size_t eleje, vege;
+    if (!tartomany(minta, m, eleje, vege))
+        return talalatok;
+    // az üres minta a lezáró jel sorára is illeszkedne
+    if (m == 0)
+        eleje = 1;
+    talalatok.reserve(vege - eleje);
+    for (size_t sor = eleje; sor < vege; ++sor)
+        talalatok.push_back(pozicio(sor));
+    return talalatok;
+}
+
+/**
+ * Megkeresi a karakter összes elöfordulásának kezdöpozícióját.
+ *
+ * @param c A keresett karakter
+ * @return A kezdöpozíciók a suffix tömb sorrendjében
+ */
+std::vector<size_t> FMIndex::locate(const char c) const {
+    return locate(&c, 1);
+}
+
+/**
+ * Megkeresi a karaktersorozat összes elöfordulásának kezdöpozícióját.
+ *
+ * @param str A keresett karaktersorozat
+ * @return A kezdöpozíciók a suffix tömb sorrendjében
+ */
+std::vector<size_t> FMIndex::locate(const char* str) const {
+    return locate(str, std::strlen(str));
+}
+
+/**
+ * Megkeresi a karaktersorozat összes elöfordulásának kezdöpozícióját.
+ *
+ * @param str A keresett karaktersorozat
+ * @return A kezdöpozíciók a suffix tömb sorrendjében
+ */
+std::vector<size_t> FMIndex::locate(const std::string& str) const {
+    return locate(str.data(), str.length());
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef FM_INDEX_H
+#define FM_INDEX_H
+
+#include <vector>
+#include <cstdint>
+
+#include "memtrace.h"
+#include "suffix_array.h"
+
+class FMIndex {
+    friend class CompressedSuffixArray;
+    size_t n;
+    std::string bwt;
+    size_t vege_sor;
+    size_t C[257];
+    short kod[256];
+    size_t abc_meret;
+    size_t occ_lepes;
+    size_t szuper_lepes;
+    std::vector<size_t> occ_szuper;
+    std::vector<unsigned short> occ_blokk;
+    size_t sa_lepes;
+    std::vector<uint64_t> jeloles;
+    std::vector<size_t> jeloles_rang;
+    std::vector<size_t> sa_minta;
+    size_t occ(unsigned char, size_t) const;
+    size_t lf(size_t) const;
+    size_t pozicio(size_t) const;
+    bool tartomany(const char*, size_t, size_t&, size_t&) const;
+    size_t count(const char*, size_t) const;
+    std::vector<size_t> locate(const char*, size_t) const;
+public:
+    FMIndex(const SuffixArray&, size_t = 32, size_t = 64);
+    size_t length() const;
+    size_t count(const char) const;
+    size_t count(const char*) const;
+    size_t count(const std::string&) const;
+    std::vector<size_t> locate(const char) const;
+    std::vector<size_t> locate(const char*) const;
+    std::vector<size_t> locate(const std::string&) const;
+};
+
+#endif // !FM_INDEX_H
\ No newline at end of file
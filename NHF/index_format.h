@@ -0,0 +1,54 @@
+#ifndef INDEX_FORMAT_H
+#define INDEX_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "memtrace.h"
+
+/**
+ * Az index fájl fejléce.
+ * Utána 8 bájtra igazítva következik a nullával lezárt szöveg, a suffix tömb és ha van, az LCP tömb.
+ */
+struct IndexFejlec {
+    char azonosito[8];
+    uint32_t verzio;
+    uint32_t szo_meret;
+    uint64_t hossz;
+    uint64_t van_lcp;
+    uint64_t szoveg_eleje;
+    uint64_t suffix_eleje;
+    uint64_t lcp_eleje;
+};
+
+static const char INDEX_AZONOSITO[8] = { 'S', 'U', 'F', 'F', 'I', 'X', 'A', 'R' };
+static const uint32_t INDEX_VERZIO = 1;
+
+/**
+ * Felfelé kerekít 8 többszörösére.
+ */
+inline uint64_t igazit(uint64_t x) {
+    return (x + 7) / 8 * 8;
+}
+
+/**
+ * Kitölti egy hossz hosszú szöveg indexének fejlécét, a szakaszok helyével együtt.
+ *
+ * @param hossz A szöveg hossza
+ * @param van_lcp Kerül-e LCP tömb a fájlba
+ * @return A kitöltött fejléc
+ */
+inline IndexFejlec index_fejlec(uint64_t hossz, bool van_lcp) {
+    IndexFejlec fejlec;
+    std::memcpy(fejlec.azonosito, INDEX_AZONOSITO, sizeof(fejlec.azonosito));
+    fejlec.verzio = INDEX_VERZIO;
+    fejlec.szo_meret = sizeof(size_t);
+    fejlec.hossz = hossz;
+    fejlec.van_lcp = van_lcp;
+    fejlec.szoveg_eleje = igazit(sizeof(IndexFejlec));
+    fejlec.suffix_eleje = igazit(fejlec.szoveg_eleje + hossz + 1);
+    fejlec.lcp_eleje = van_lcp ? fejlec.suffix_eleje + hossz * sizeof(size_t) : 0;
+    return fejlec;
+}
+
+#endif // !INDEX_FORMAT_H
\ No newline at end of file
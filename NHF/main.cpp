@@ -1,14 +1,83 @@
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <fstream>
+#include <sstream>
 
 #include "memtrace.h"
 #include "gtest_lite.h"
 #include "suffix_array.h"
+#include "fm_index.h"
+#include "compressed_suffix_array.h"
+#include "query_pool.h"
+#include "document_collection.h"
+#include "external_builder.h"
+#include "benchmark.h"
+#include "driver.h"
+#include "simd_compare.h"
+#include "index_format.h"
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        epites_benchmark(std::cout, argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1024);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--parallel-benchmark") {
+        parhuzamos_benchmark(std::cout, argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256, argc > 3 ? (unsigned)std::strtoul(argv[3], nullptr, 10) : 0);
+        return 0;
+    }
+    if (argc > 2 && std::string(argv[1]) == "--file") {
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr);
+        try {
+            if (argc > 3) {
+                std::ifstream lekerdezesek(argv[3]);
+                if (!lekerdezesek)
+                    throw std::runtime_error(std::string("Nem nyithato meg: ") + argv[3]);
+                fajl_kereses(argv[2], lekerdezesek, std::cout);
+            } else {
+                fajl_kereses(argv[2], std::cin, std::cout);
+            }
+        }
+        catch (std::exception& e) {
+            std::cerr << "A hiba oka: " << e.what() << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+    if (argc > 3 && std::string(argv[1]) == "--build-external") {
+        try {
+            ExternalBuilder(argc > 4 ? std::strtoul(argv[4], nullptr, 10) << 20 : (size_t)256 << 20).build(argv[2], argv[3]);
+        }
+        catch (std::exception& e) {
+            std::cout << "A hiba oka: " << e.what() << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--batch-benchmark") {
+        kotegelt_kereses_benchmark(std::cout, argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64, argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000000);
+        return 0;
+    }
 
-int main() {
     TEST(Alap, konstruktor) {
         SuffixArray sa("Szoveg Szoveg");
         EXPECT_STREQ("Szoveg Szoveg", sa.c_str()) << "Hiba a szoveg masolasakor.";
+        std::string hosszu(1000, 'x');
+        const char* adat = hosszu.c_str();
+        SuffixArray atvett(std::move(hosszu));
+        EXPECT_EQ(adat, atvett.c_str()) << "Nem vette at a stringet.";
+        EXPECT_EQ((size_t)999, atvett[0]) << "Hibas suffix tomb.";
     } END;
 
     TEST(Alap, masolo_konstruktor) {
@@ -17,6 +86,29 @@ int main() {
         EXPECT_STREQ(sa.c_str(), masolat.c_str()) << "Hiba a masolo konstruktorban.";
     } END;
 
+    TEST(Alap, mozgato_konstruktor) {
+        SuffixArray sa("Szoveg Szoveg");
+        sa.lcpEpites();
+        SuffixArray uj(std::move(sa));
+        EXPECT_STREQ("Szoveg Szoveg", uj.c_str()) << "Hiba a mozgato konstruktorban.";
+        EXPECT_TRUE(uj.vanLcp()) << "Nem mozgott at az LCP tomb.";
+        EXPECT_EQ((size_t)0, sa.length()) << "A mozgatott objektum nem ures.";
+        EXPECT_FALSE(sa.keres("Sz") != sa.end()) << "A mozgatott objektumban van talalat.";
+        std::vector<SuffixArray> tarolo;
+        for (int i = 0; i < 10; ++i)
+            tarolo.push_back(SuffixArray(std::string(i + 1, 'a')));
+        EXPECT_STREQ("aaaaaaaaaa", tarolo.back().c_str()) << "Hiba a vectorban tarolaskor.";
+    } END;
+
+    TEST(Alap, mozgato_ertekado_operator) {
+        SuffixArray sa1("Szoveg Szoveg");
+        SuffixArray sa2("abc");
+        sa2 = std::move(sa1);
+        EXPECT_STREQ("Szoveg Szoveg", sa2.c_str()) << "Hiba a mozgato ertekado operatorban.";
+        SuffixArray::iterator it = sa2.keres("oveg ");
+        EXPECT_STREQ("oveg Szoveg", it->c_str()) << "Hibas talalat mozgatas utan.";
+    } END;
+
     TEST(Alap, ertekado_operator1) {
         SuffixArray sa1("Szoveg Szoveg");
         SuffixArray sa2("");
@@ -37,12 +129,106 @@ int main() {
         EXPECT_STREQ("Szoveg Szoveg Szoveg", sa1.c_str()) << "Hiba a hozzaado operatorban.";
     } END;
 
+    TEST(Alap, hozzaado_operator_rendezett) {
+        SuffixArray sa("abaab");
+        sa.lcpEpites();
+        sa += std::string("abac");
+        sa += SuffixArray("ab");
+        SuffixArray ujraepitett("abaababacab");
+        ujraepitett.lcpEpites();
+        for (size_t i = 0; i < sa.length(); ++i) {
+            EXPECT_EQ(ujraepitett[i], sa[i]) << "Hibas suffix sorrend hozzafuzes utan: " << i;
+            EXPECT_EQ(ujraepitett.lcp(i), sa.lcp(i)) << "Hibas LCP hozzafuzes utan: " << i;
+        }
+        SuffixArray::iterator it = sa.keres("abac");
+        EXPECT_STREQ("abacab", it->c_str()) << "Hibas talalat hozzafuzes utan.";
+    } END;
+
+    TEST(Alap, hozzaado_operator_periodikus) {
+        const char* periodusok[] = { "a", "ab", "abaab" };
+        for (const char* periodus : periodusok) {
+            std::string szoveg;
+            while (szoveg.length() < 5000)
+                szoveg += periodus;
+            SuffixArray sa(szoveg);
+            sa.lcpEpites();
+            sa += std::string(periodus);
+            sa += std::string("a");
+            SuffixArray ujraepitett(szoveg + periodus + "a");
+            ujraepitett.lcpEpites();
+            for (size_t i = 0; i < sa.length(); ++i) {
+                EXPECT_EQ(ujraepitett[i], sa[i]) << "Hibas suffix sorrend hozzafuzes utan: " << periodus << " " << i;
+                EXPECT_EQ(ujraepitett.lcp(i), sa.lcp(i)) << "Hibas LCP hozzafuzes utan: " << periodus << " " << i;
+            }
+        }
+    } END;
+
     TEST(Alap, osszeado_operator) {
         SuffixArray sa1("Szoveg Szoveg");
         SuffixArray sa2(" Szoveg");
         EXPECT_STREQ("Szoveg Szoveg Szoveg", (sa1 + sa2).c_str()) << "Hiba a osszeado operatorban.";
     } END;
 
+    TEST(Alap, sais_es_rendezes_egyezik) {
+        const char* szovegek[] = { "", "a", "aa", "banana", "mississippi", "asdasdasd", "Szoveg Szoveg", "abracadabra abracadabra" };
+        for (const char* str : szovegek) {
+            SuffixArray sais(str);
+            SuffixArray rendezes(str, SuffixArray::RENDEZES);
+            SuffixArray::iterator it1 = sais.keres("");
+            SuffixArray::iterator it2 = rendezes.keres("");
+            for (; it1 != sais.end() && it2 != rendezes.end(); ++it1, ++it2)
+                EXPECT_STREQ(it2->c_str(), it1->c_str()) << "Elter az SA-IS es a rendezes eredmenye: " << str;
+            EXPECT_FALSE(it1 != sais.end() || it2 != rendezes.end()) << "Elter a suffixek szama: " << str;
+        }
+    } END;
+
+    TEST(Alap, parhuzamos_epites) {
+        const char* szovegek[] = { "", "a", "banana", "mississippi", "abracadabra abracadabra" };
+        for (const char* str : szovegek) {
+            SuffixArray sais(str);
+            SuffixArray parhuzamos(str, SuffixArray::PARHUZAMOS);
+            for (size_t i = 0; i < sais.length(); ++i)
+                EXPECT_EQ(sais[i], parhuzamos[i]) << "Elter az SA-IS es a parhuzamos epites eredmenye: " << str;
+        }
+        std::string hosszu;
+        for (size_t i = 0; hosszu.length() < 100000; ++i)
+            hosszu += i % 7 == 0 ? std::string("abcabcabcabc") : std::to_string(i * i % 1009);
+        SuffixArray sais(hosszu);
+        SuffixArray parhuzamos(hosszu, SuffixArray::PARHUZAMOS, 4);
+        size_t elteres = 0;
+        for (size_t i = 0; i < sais.length(); ++i)
+            elteres += sais[i] != parhuzamos[i];
+        EXPECT_EQ((size_t)0, elteres) << "Elter az SA-IS es a 4 szalu epites eredmenye.";
+        std::string periodikus(70000, 'a');
+        for (size_t i = 0; i < periodikus.length(); i += 1000)
+            periodikus[i] = 'b';
+        SuffixArray periodikus_sais(periodikus);
+        for (unsigned szalak = 1; szalak <= 4; szalak *= 4) {
+            SuffixArray periodikus_parhuzamos(periodikus, SuffixArray::PARHUZAMOS, szalak);
+            elteres = 0;
+            for (size_t i = 0; i < periodikus_sais.length(); ++i)
+                elteres += periodikus_sais[i] != periodikus_parhuzamos[i];
+            EXPECT_EQ((size_t)0, elteres) << "Elter az SA-IS es a parhuzamos epites periodikus szovegen: " << szalak;
+        }
+    } END;
+
+    TEST(Alap, lcp_tomb) {
+        SuffixArray sa("banana");
+        EXPECT_THROW(sa.lcp(0), std::logic_error&);
+        sa.lcpEpites();
+        EXPECT_TRUE(sa.vanLcp());
+        const size_t elvart[] = { 0, 1, 3, 0, 0, 2 };
+        size_t osszeg = 0;
+        for (size_t i = 0; i < sa.length(); ++i) {
+            EXPECT_EQ(elvart[i], sa.lcp(i)) << "Hibas LCP ertek: " << i;
+            osszeg += sa.lcp(i);
+        }
+        EXPECT_EQ((size_t)15, sa.length() * (sa.length() + 1) / 2 - osszeg) << "Hibas kulonbozo reszszovegszam.";
+        EXPECT_THROW(sa.lcp(6), std::out_of_range&);
+        SuffixArray masolat(sa);
+        EXPECT_EQ((size_t)3, masolat.lcp(2)) << "Nem masolodott az LCP tomb.";
+    } END;
+
     TEST(Iterator, kezdetu_szovegek1) {
         SuffixArray sa("Szoveg Szoveg");
         SuffixArray::iterator it = sa.keres(std::string("oveg"));
@@ -73,6 +259,33 @@ int main() {
         EXPECT_FALSE(it != sa.end()) << "Tul sok talalat.";
     } END;
 
+    TEST(Iterator, talalatok_szama) {
+        std::string szoveg = "abracadabra abracadabra cadabra";
+        SuffixArray sa(szoveg);
+        const char* mintak[] = { "a", "abra", "cad", "bra ", "x", "abracadabra", "ra", "" };
+        for (const char* minta : mintak) {
+            size_t elvart = 0;
+            for (size_t i = 0; i < szoveg.length(); ++i)
+                if (szoveg.compare(i, std::strlen(minta), minta) == 0)
+                    elvart++;
+            size_t talalat = 0;
+            for (SuffixArray::iterator it = sa.keres(minta); it != sa.end(); ++it) {
+                EXPECT_EQ(0, std::strncmp(minta, it->c_str(), std::strlen(minta))) << "Hibas talalat: " << minta;
+                talalat++;
+            }
+            EXPECT_EQ(elvart, talalat) << "Hibas talalatszam: " << minta;
+        }
+    } END;
+
+    TEST(Iterator, suffix_nezet) {
+        SuffixArray sa("Szoveg Szoveg");
+        SuffixArray::iterator it = sa.keres("Sz");
+        EXPECT_EQ((size_t)6, it->length()) << "Hibas suffix hossz.";
+        EXPECT_TRUE(*it == std::string("Szoveg")) << "Hibas suffix osszehasonlitas.";
+        EXPECT_STREQ("ove", it->substr(2, 3).c_str()) << "Hibas suffix reszlet.";
+        EXPECT_THROW((*it)[6], std::out_of_range&);
+    } END;
+
     TEST(Iterator, ures_stringben_kereses) {
         SuffixArray sa("");
         SuffixArray::iterator it = sa.keres("Hello");
@@ -111,6 +324,124 @@ int main() {
         EXPECT_THROW(it->c_str(), std::out_of_range&);
     } END;
 
+    TEST(Iterator, talalati_tartomany) {
+        SuffixArray sa("abracadabra abracadabra");
+        SuffixArray::range r = sa.talalatok("abra");
+        EXPECT_EQ((size_t)4, r.size()) << "Hibas talalatszam.";
+        EXPECT_EQ((std::ptrdiff_t)4, std::distance(r.begin(), r.end())) << "Hibas tavolsag.";
+        EXPECT_TRUE((std::is_same<std::iterator_traits<SuffixArray::range::const_iterator>::iterator_category, std::input_iterator_tag>::value)) << "Hibas iterator kategoria.";
+#ifdef __cpp_lib_ranges
+        EXPECT_TRUE(std::random_access_iterator<SuffixArray::range::const_iterator>) << "Hibas iterator koncepcio.";
+#endif
+        EXPECT_STREQ("abra", r[0].c_str()) << "Hibas elso talalat.";
+        EXPECT_STREQ("abracadabra abracadabra", r.begin()[3].c_str()) << "Hibas utolso talalat.";
+        EXPECT_EQ((size_t)0, r.pozicio(3)) << "Hibas pozicio.";
+        EXPECT_EQ(r.pozicio(1), (r.end() - 3).pozicio()) << "Hibas visszafele leptetes.";
+        EXPECT_THROW(r[4], std::out_of_range&);
+        EXPECT_THROW(r.pozicio(4), std::out_of_range&);
+        std::vector<size_t> poziciok;
+        for (SuffixArray::range::const_iterator it = r.begin(); it != r.end(); ++it)
+            poziciok.push_back(it.pozicio());
+        std::sort(poziciok.begin(), poziciok.end());
+        EXPECT_EQ((size_t)0, poziciok[0]) << "Hibas pozicio.";
+        EXPECT_EQ((size_t)19, poziciok[3]) << "Hibas pozicio.";
+        EXPECT_EQ((std::ptrdiff_t)2, std::count_if(r.begin(), r.end(), [](const SuffixArray::suffix_view& s) { return s.length() > 11; })) << "Hibas count_if.";
+        EXPECT_TRUE(std::is_sorted(r.begin(), r.end(), [](const SuffixArray::suffix_view& a, const SuffixArray::suffix_view& b) { return a.substr() < b.substr(); })) << "Nem rendezettek a talalatok.";
+        EXPECT_TRUE(sa.talalatok('x').empty()) << "Hibas talalat a keresesben.";
+        EXPECT_EQ(sa.length(), sa.talalatok("").size()) << "Az ures minta minden suffixre illeszkedik.";
+        EXPECT_TRUE(SuffixArray("").talalatok("a").empty()) << "Hibas talalat ures szovegben.";
+        SuffixArray::iterator it = sa.talalatok("cad");
+        EXPECT_STREQ("cadabra", it->c_str()) << "Hibas atalakitas iteratorra.";
+        EXPECT_TRUE(SuffixArray::iterator(sa.talalatok("x")) == sa.end()) << "Hibas atalakitas iteratorra.";
+    } END;
+
+    TEST(Iterator, locate) {
+        SuffixArray sa("abracadabra abracadabra");
+        std::vector<size_t> sa_sorrend = sa.locate("abra");
+        std::vector<size_t> elvart = { 19, 7, 12, 0 };
+        EXPECT_TRUE(elvart == sa_sorrend) << "Hibas poziciok suffix tomb sorrendben.";
+        std::vector<size_t> szoveg_sorrend = sa.locate("abra", true);
+        std::sort(elvart.begin(), elvart.end());
+        EXPECT_TRUE(elvart == szoveg_sorrend) << "Hibas poziciok szoveg sorrendben.";
+        EXPECT_EQ((size_t)10, sa.locate('a').size()) << "Hibas talalatszam.";
+        EXPECT_TRUE(sa.locate("x", true).empty()) << "Hibas talalat a keresesben.";
+        std::vector<size_t> folyam;
+        sa.locate_each("abra", [&folyam](size_t pos) { folyam.push_back(pos); });
+        EXPECT_TRUE(folyam == sa_sorrend) << "Elter a folyamatos es az egyben visszaadott eredmeny.";
+
+        std::string hosszu;
+        for (size_t i = 0; i < 20000; ++i)
+            hosszu += i % 3 == 0 ? "ab" : "ba";
+        SuffixArray nagy(hosszu);
+        std::vector<size_t> poziciok = nagy.locate("ab", true);
+        bool rendezett = std::is_sorted(poziciok.begin(), poziciok.end());
+        EXPECT_TRUE(rendezett) << "Nem rendezettek a poziciok.";
+        size_t rossz = 0;
+        for (size_t pos : poziciok)
+            rossz += hosszu.compare(pos, 2, "ab") != 0;
+        EXPECT_EQ((size_t)0, rossz) << "Hibas pozicio.";
+        EXPECT_EQ(nagy.talalatok("ab").size(), poziciok.size()) << "Hibas talalatszam.";
+    } END;
+
+    TEST(Iterator, kotegelt_kereses) {
+        SuffixArray sa("abracadabra abracadabra");
+        std::vector<std::string> mintak = { "bra", "abra", "x", "", "a", "abra", "cad", "abracadabra ", "ra a" };
+        std::vector<SuffixArray::range> talalatok = sa.keres_batch(mintak);
+        EXPECT_EQ(mintak.size(), talalatok.size()) << "Hibas talalatszam.";
+        for (size_t i = 0; i < mintak.size(); ++i) {
+            SuffixArray::iterator it1 = sa.keres(mintak[i]), it2 = talalatok[i];
+            for (; it1 != sa.end() && it2 != sa.end(); ++it1, ++it2)
+                EXPECT_STREQ(it1->c_str(), it2->c_str()) << "Elter a kotegelt es az egyenkenti kereses: " << mintak[i];
+            EXPECT_FALSE(it1 != sa.end() || it2 != sa.end()) << "Elter a talalatok szama: " << mintak[i];
+        }
+        EXPECT_TRUE(talalatok[2].empty()) << "Hibas talalat a keresesben.";
+        EXPECT_EQ((size_t)4, talalatok[1].size()) << "Hibas talalatszam.";
+        EXPECT_TRUE(SuffixArray("").keres_batch(mintak)[0].empty()) << "Hibas talalat ures szovegben.";
+    } END;
+
+    TEST(Iterator, string_view_kereses) {
+        SuffixArray sa("asdasdasd");
+        CompressedSuffixArray csa(sa, 4);
+        const char sor[] = "xxsdayy";
+        std::string_view minta(sor + 2, 3);
+        EXPECT_EQ(sa.talalatok("sda").size(), sa.talalatok(minta).size()) << "Hibas talalatszam.";
+        SuffixArray::iterator it = sa.keres(minta);
+        CompressedSuffixArray::iterator csa_it = csa.keres(minta);
+        for (SuffixArray::iterator vart = sa.keres("sda"); vart != sa.end(); ++vart, ++it, ++csa_it) {
+            EXPECT_STREQ(vart->c_str(), it->c_str()) << "Hibas talalat a keresesben.";
+            EXPECT_STREQ(vart->c_str(), csa_it->c_str()) << "Hibas talalat a tomoritett keresesben.";
+        }
+        EXPECT_FALSE(it != sa.end()) << "Tul sok talalat.";
+        EXPECT_FALSE(csa_it != csa.end()) << "Tul sok talalat.";
+        EXPECT_EQ(sa.length(), sa.talalatok(std::string_view()).size()) << "Az ures minta mindenre illeszkedik.";
+        EXPECT_EQ((size_t)3, sa.talalatok(std::string_view("d")).size()) << "Hibas talalatszam.";
+    } END;
+
+    TEST(QueryPool, parhuzamos_kereses) {
+        std::string szoveg;
+        for (size_t i = 0; i < 2000; ++i)
+            szoveg += std::to_string(i * 7919 % 10007) + (i % 3 == 0 ? " abra" : " cadabra");
+        SuffixArray sa(szoveg);
+        std::vector<std::string> mintak;
+        for (size_t i = 0; i < 3000; ++i)
+            mintak.push_back(i % 5 == 0 ? std::string("x") + std::to_string(i) : szoveg.substr(i * 13 % (szoveg.length() - 12), 3 + i % 10));
+        mintak.push_back("");
+        QueryPool pool(4);
+        EXPECT_EQ(4u, pool.size()) << "Hibas szalszam.";
+        for (int kor = 0; kor < 2; ++kor) {
+            std::vector<SuffixArray::range> talalatok = pool.keres(sa, mintak);
+            size_t elteres = 0;
+            for (size_t i = 0; i < mintak.size(); ++i) {
+                SuffixArray::iterator it1 = sa.keres(mintak[i]), it2 = talalatok[i];
+                for (; it1 != sa.end() && it2 != sa.end(); ++it1, ++it2)
+                    elteres += it1->c_str() != it2->c_str();
+                elteres += it1 != sa.end() || it2 != sa.end();
+            }
+            EXPECT_EQ((size_t)0, elteres) << "Elter a parhuzamos es az egyenkenti kereses.";
+        }
+        EXPECT_TRUE(pool.keres(sa, std::vector<std::string>()).empty()) << "Hibas talalat ures mintalistara.";
+    } END;
+
     TEST(Iterator, leghosszabb_kozos_szoveg1) {
         SuffixArray sa1("Hello World!");
         SuffixArray sa2("xyzHelloxyzWorld!xzy");
@@ -132,6 +463,274 @@ int main() {
         EXPECT_STREQ("lmnop", leghosszabb_kozos_str.c_str()) << "Hiba a leghosszabb kozos string meghatarozasakor.";
     } END;
 
+    TEST(Iterator, leghosszabb_kozos_szoveg4) {
+        SuffixArray sa1("xxabyycd");
+        SuffixArray sa2("cdzab");
+        EXPECT_STREQ("cd", (sa1 & sa2).c_str()) << "Nem a rovidebb szovegben elso kozos string.";
+        EXPECT_STREQ("cd", (sa2 & sa1).c_str()) << "Nem a rovidebb szovegben elso kozos string.";
+    } END;
+
+    TEST(FMIndex, count_es_locate) {
+        std::string szoveg = "abracadabra abracadabra cadabra";
+        SuffixArray sa(szoveg);
+        FMIndex fm(sa, 4, 8);
+        const char* mintak[] = { "a", "abra", "cad", "bra ", "x", "abracadabra", "ra" };
+        for (const char* minta : mintak) {
+            std::vector<size_t> elvart;
+            for (size_t i = 0; i < szoveg.length(); ++i)
+                if (szoveg.compare(i, std::strlen(minta), minta) == 0)
+                    elvart.push_back(i);
+            EXPECT_EQ(elvart.size(), fm.count(minta)) << "Hibas talalatszam: " << minta;
+            std::vector<size_t> poziciok = fm.locate(std::string(minta));
+            std::sort(poziciok.begin(), poziciok.end());
+            EXPECT_TRUE(elvart == poziciok) << "Hibas poziciok: " << minta;
+        }
+        EXPECT_EQ((size_t)13, fm.count('a')) << "Hibas karakterszam.";
+        EXPECT_EQ((size_t)0, fm.count('z')) << "Hibas karakterszam.";
+        EXPECT_THROW(FMIndex(sa, 0), std::invalid_argument&);
+    } END;
+
+    TEST(CompressedSuffixArray, kereses) {
+        SuffixArray sa("asdasdasd");
+        CompressedSuffixArray csa(sa, 4);
+        for (size_t i = 0; i < sa.length(); ++i) {
+            EXPECT_EQ(sa[i], csa[i]) << "Hibas suffix tomb ertek: " << i;
+            EXPECT_EQ(i, csa.rang(sa[i])) << "Hibas inverz suffix tomb ertek: " << i;
+        }
+        CompressedSuffixArray::iterator it = csa.keres('d');
+        EXPECT_STREQ("d", it->c_str()) << "Hibas talalat a keresesben.";
+        EXPECT_NO_THROW(++it);
+        EXPECT_STREQ("dasd", it->c_str()) << "Hibas talalat a keresesben.";
+        EXPECT_NO_THROW(++it);
+        EXPECT_STREQ("dasdasd", it->c_str()) << "Hibas talalat a keresesben.";
+        EXPECT_NO_THROW(++it);
+        EXPECT_FALSE(it != csa.end()) << "Tul sok talalat.";
+        EXPECT_THROW(++it, std::out_of_range&);
+        EXPECT_FALSE(csa.keres("x") != csa.end()) << "Hibas talalat a keresesben.";
+    } END;
+
+    TEST(DocumentCollection, dokumentumok) {
+        std::vector<std::string> dokumentumok = { "abcab", "", "bcd", "abcabcab", "cab" };
+        DocumentCollection gy(dokumentumok);
+        EXPECT_EQ((size_t)5, gy.size()) << "Hibas dokumentumszam.";
+        EXPECT_EQ((size_t)2, gy.count("abc", 3)) << "Hibas dokumentumonkenti darabszam.";
+        EXPECT_EQ((size_t)0, gy.count("abc", 2)) << "Hibas dokumentumonkenti darabszam.";
+        EXPECT_THROW(gy.count("abc", 5), std::out_of_range&);
+        std::vector<DocumentCollection::hit> talalatok = gy.keres("cab");
+        EXPECT_EQ((size_t)4, talalatok.size()) << "Hibas talalatszam.";
+        EXPECT_EQ(gy.count("cab"), talalatok.size()) << "Hibas darabszam.";
+        size_t rossz = 0;
+        for (const DocumentCollection::hit& h : talalatok)
+            rossz += dokumentumok[h.dokumentum].compare(h.pozicio, 3, "cab") != 0;
+        EXPECT_EQ((size_t)0, rossz) << "Hibas (dokumentum, pozicio) par.";
+        // a dokumentumhatron tnyl szveg nem tallat
+        EXPECT_EQ((size_t)0, gy.count("bbc")) << "Dokumentumhataron atnyulo talalat.";
+        EXPECT_EQ((size_t)0, gy.count(std::string("ab\0bc", 5))) << "Dokumentumhataron atnyulo talalat.";
+        EXPECT_EQ((size_t)19, gy.count("")) << "Az ures minta minden pozicion elofordul.";
+        std::vector<size_t> lista = gy.dokumentumok("ab");
+        std::vector<size_t> elvart = { 0, 3, 4 };
+        EXPECT_TRUE(elvart == lista) << "Hibas dokumentumlista.";
+        EXPECT_TRUE(gy.dokumentumok("x").empty()) << "Hibas dokumentumlista.";
+        std::vector<std::pair<size_t, size_t> > top = gy.top_k("ab", 2);
+        EXPECT_EQ((size_t)2, top.size()) << "Hibas top-k meret.";
+        EXPECT_EQ((size_t)3, top[0].first) << "Hibas top-k dokumentum.";
+        EXPECT_EQ((size_t)3, top[0].second) << "Hibas top-k gyakorisag.";
+        EXPECT_EQ((size_t)0, top[1].first) << "Hibas top-k dokumentum.";
+        EXPECT_EQ((size_t)2, top[1].second) << "Hibas top-k gyakorisag.";
+        EXPECT_EQ((size_t)3, gy.top_k("ab", 10).size()) << "Hibas top-k meret.";
+        EXPECT_EQ((size_t)0, DocumentCollection(std::vector<std::string>()).count("a")) << "Hibas talalat ures gyujtemenyben.";
+    } END;
+
+    TEST(SuffixArray, mentes_es_lekepezes) {
+        const char* fajl = "nhf_teszt.idx";
+        SuffixArray sa("banana");
+        sa.lcpEpites();
+        EXPECT_NO_THROW(sa.save(fajl));
+        {
+            SuffixArray betoltott = SuffixArray::open(fajl);
+            EXPECT_STREQ("banana", betoltott.c_str()) << "Hibas betoltott szoveg.";
+            EXPECT_TRUE(betoltott.vanLcp()) << "Nem toltodott be az LCP tomb.";
+            for (size_t i = 0; i < sa.length(); ++i) {
+                EXPECT_EQ(sa[i], betoltott[i]) << "Hibas suffix tomb ertek: " << i;
+                EXPECT_EQ(sa.lcp(i), betoltott.lcp(i)) << "Hibas LCP ertek: " << i;
+            }
+            SuffixArray::iterator it = betoltott.keres("an");
+            EXPECT_STREQ("ana", it->c_str()) << "Hibas talalat a keresesben.";
+            betoltott += std::string("bandana");
+            EXPECT_STREQ("bananabandana", betoltott.c_str()) << "Hibas hozzafuzes a betoltott tombhoz.";
+            EXPECT_EQ(SuffixArray("bananabandana")[0], betoltott[0]) << "Hibas suffix tomb a hozzafuzes utan.";
+        }
+        std::remove(fajl);
+        EXPECT_THROW(SuffixArray::open(fajl), std::runtime_error&);
+    } END;
+
+    TEST(SuffixArray, serult_index) {
+        const char* fajl = "nhf_teszt.idx";
+        SuffixArray sa("banana");
+        sa.lcpEpites();
+        sa.save(fajl);
+        std::string eredeti;
+        {
+            std::ifstream be(fajl, std::ios::binary);
+            std::ostringstream tartalom;
+            tartalom << be.rdbuf();
+            eredeti = tartalom.str();
+        }
+        IndexFejlec fejlec;
+        std::memcpy(&fejlec, eredeti.data(), sizeof(fejlec));
+        std::vector<std::string> hibasak;
+        hibasak.push_back(eredeti.substr(0, sizeof(fejlec) - 1));
+        hibasak.push_back(eredeti.substr(0, eredeti.length() - 1));
+        IndexFejlec hamis = fejlec;
+        hamis.szoveg_eleje = ~(uint64_t)0 - 2;
+        hibasak.push_back(std::string((const char*)&hamis, sizeof(hamis)) + eredeti.substr(sizeof(hamis)));
+        hamis = fejlec;
+        hamis.suffix_eleje = ~(uint64_t)0 - 7;
+        hibasak.push_back(std::string((const char*)&hamis, sizeof(hamis)) + eredeti.substr(sizeof(hamis)));
+        hamis = fejlec;
+        hamis.hossz = ~(uint64_t)0 / 2;
+        hibasak.push_back(std::string((const char*)&hamis, sizeof(hamis)) + eredeti.substr(sizeof(hamis)));
+        for (size_t i = 0; i < hibasak.size(); ++i) {
+            {
+                std::ofstream ki(fajl, std::ios::binary | std::ios::trunc);
+                ki.write(hibasak[i].data(), hibasak[i].length());
+            }
+            EXPECT_THROW(SuffixArray::open(fajl), std::runtime_error&) << "Elfogadott hibas index: " << i;
+        }
+        // a tmbk elemeit a konstans idej megnyits nem nzi, csak a krt ellenrzs
+        std::string rossz_sa = eredeti;
+        size_t kivul = 1000;
+        std::memcpy(&rossz_sa[fejlec.suffix_eleje], &kivul, sizeof(kivul));
+        {
+            std::ofstream ki(fajl, std::ios::binary | std::ios::trunc);
+            ki.write(rossz_sa.data(), rossz_sa.length());
+        }
+        EXPECT_NO_THROW(SuffixArray::open(fajl)) << "A megnyitas vegignezte a tombot.";
+        EXPECT_THROW(SuffixArray::open(fajl, true), std::runtime_error&) << "Elfogadott hibas suffix tomb.";
+        {
+            std::ofstream ki(fajl, std::ios::binary | std::ios::trunc);
+            ki.write(eredeti.data(), eredeti.length());
+        }
+        EXPECT_NO_THROW(SuffixArray::open(fajl, true)) << "Elutasitott ep index.";
+        std::remove(fajl);
+    } END;
+
+    TEST(ExternalBuilder, kulso_epites) {
+        const char* bemenet = "nhf_teszt.txt";
+        const char* kimenet = "nhf_teszt_kulso.idx";
+        std::string szoveg;
+        for (int i = 0; i < 300; ++i)
+            szoveg += i % 7 == 0 ? "abracadabra" : std::string(1, (char)('a' + i * i % 5));
+        // hossz ismtlds: a futamok kzt sok egyez kulcs, ezeket a szveg alapjn kell sszefslni
+        for (int i = 0; i < 40; ++i)
+            szoveg += "abcab";
+        {
+            std::ofstream fajl(bemenet, std::ios::binary);
+            fajl << szoveg;
+        }
+        SuffixArray sa(szoveg);
+        // 1 KB memrival sok blokk s futam keletkezik, az alaprtelmezettel egy blokk
+        size_t korlatok[] = { 1024, (size_t)256 << 20 };
+        EXPECT_EQ((size_t)64, ExternalBuilder(1024).blokk_meret()) << "Hibas blokkmeret.";
+        for (size_t korlat : korlatok) {
+            EXPECT_NO_THROW(ExternalBuilder(korlat).build(bemenet, kimenet));
+            SuffixArray betoltott = SuffixArray::open(kimenet);
+            EXPECT_STREQ(szoveg.c_str(), betoltott.c_str()) << "Hibas betoltott szoveg.";
+            for (size_t i = 0; i < sa.length(); ++i)
+                EXPECT_EQ(sa[i], betoltott[i]) << "Hibas suffix tomb ertek: " << i;
+            EXPECT_EQ(sa.talalatok("abra").size(), betoltott.talalatok("abra").size()) << "Hibas talalatszam.";
+            // 1 KB-nl kettesvel, tbb menetben fsl; egyik menet futamai sem maradhatnak meg
+            for (int i = 0; i < 32; ++i)
+                EXPECT_FALSE(std::ifstream(std::string(kimenet) + ".futam" + std::to_string(i)).is_open()) << "Megmaradt futam: " << i;
+        }
+        std::remove(bemenet);
+        std::remove(kimenet);
+        EXPECT_THROW(ExternalBuilder().build(bemenet, kimenet), std::runtime_error&);
+    } END;
+
+    TEST(Driver, fajl_kereses) {
+        const char* szoveg_fajl = "nhf_teszt.txt";
+        const char* index_fajl = "nhf_teszt.idx";
+        {
+            std::ofstream fajl(szoveg_fajl, std::ios::binary);
+            fajl << "abracadabra";
+        }
+        SuffixArray("abracadabra").save(index_fajl);
+        const char* fajlok[] = { szoveg_fajl, index_fajl };
+        for (const char* fajl : fajlok) {
+            std::istringstream be("abra\r\n\nx\ncad\n");
+            std::ostringstream ki;
+            EXPECT_NO_THROW(fajl_kereses(fajl, be, ki));
+            EXPECT_STREQ("abra\t2\t0 7\nx\t0\t\ncad\t1\t4\n", ki.str().c_str()) << "Hibas kimenet: " << fajl;
+        }
+        std::remove(szoveg_fajl);
+        std::remove(index_fajl);
+        std::istringstream be("a\n");
+        std::ostringstream ki;
+        EXPECT_THROW(fajl_kereses(szoveg_fajl, be, ki), std::runtime_error&);
+    } END;
+
+    TEST(SimdCompare, kozos_prefix) {
+        std::string a(200, 'x'), b(200, 'x');
+        SimdSzint szintek[] = { SKALAR, SSE2, AVX2 };
+        for (SimdSzint szint : szintek) {
+            for (size_t eltolas = 0; eltolas < 3; ++eltolas) {
+                for (size_t n = 0; n + eltolas <= 100; ++n) {
+                    EXPECT_EQ(n, kozos_prefix(a.data() + eltolas, b.data(), n, szint)) << "Hibas egyezo hossz: " << simd_nev(szint);
+                    for (size_t k = 0; k < n; ++k) {
+                        b[k] = (char)0xF0;
+                        EXPECT_EQ(k, kozos_prefix(a.data() + eltolas, b.data(), n, szint)) << "Hibas elteres: " << simd_nev(szint) << " " << k;
+                        b[k] = 'x';
+                    }
+                }
+            }
+        }
+        std::string sz = "abababababababababababababababababababababababab\xff";
+        for (size_t i = 0; i < sz.length(); ++i)
+            for (size_t j = 0; j < sz.length(); ++j)
+                EXPECT_EQ(sz.compare(i, std::string::npos, sz, j, std::string::npos) < 0, suffix_kisebb(sz.data(), sz.length(), i, j)) << "Hibas suffix sorrend: " << i << " " << j;
+    } END;
+
+    TEST(Arena, foglalas_es_visszatekeres) {
+        Arena arena(256);
+        void* elso = arena.foglal(3, 1);
+        void* igazitott = arena.foglal(sizeof(double), alignof(double));
+        EXPECT_EQ((size_t)0, (size_t)igazitott % alignof(double)) << "Hibas igazitas.";
+        EXPECT_NE(elso, igazitott) << "Atfedo foglalasok.";
+        {
+            Arena::Jelolo jelolo(arena);
+            arena.foglal(1000);
+        }
+        EXPECT_EQ((size_t)2, arena.upstream_foglalasok()) << "Hibas upstream foglalasszam.";
+        void* ujra = arena.foglal(1000);
+        EXPECT_EQ((size_t)2, arena.upstream_foglalasok()) << "A visszatekert blokk nem lett ujrahasznalva.";
+        EXPECT_NE((void*)0, ujra) << "Sikertelen foglalas.";
+        arena.reset();
+        EXPECT_EQ(elso, arena.foglal(3, 1)) << "A reset nem az elejere tekert.";
+    } END;
+
+    TEST(Arena, locate) {
+        SuffixArray sa("mississippi missouri");
+        Arena arena(1024);
+        const char* mintak[] = { "ss", "i", "m", "issi", "x" };
+        size_t upstream = 0;
+        for (int kor = 0; kor < 3; ++kor) {
+            for (const char* minta : mintak) {
+                arena.reset();
+                for (int sorrend = 0; sorrend < 2; ++sorrend) {
+                    std::vector<size_t> vart = sa.locate(minta, sorrend == 1);
+                    ArenaVector<size_t> kapott = sa.locate(std::string(minta), arena, sorrend == 1);
+                    EXPECT_TRUE(std::equal(vart.begin(), vart.end(), kapott.begin()) && vart.size() == kapott.size()) << "Hibas talalatok: " << minta;
+                }
+                ArenaVector<size_t> karakter = sa.locate(minta[0], arena, true);
+                EXPECT_EQ(sa.locate(minta[0], true).size(), karakter.size()) << "Hibas karakteres talalatok: " << minta;
+            }
+            if (kor == 0)
+                upstream = arena.upstream_foglalasok();
+        }
+        EXPECT_EQ(upstream, arena.upstream_foglalasok()) << "Bemelegedes utan is foglal.";
+    } END;
+
     try {
         std::cout << std::endl;
         std::string szoveg;
@@ -146,7 +745,8 @@ int main() {
             std::cout << "Nem talalhato egyezes a szovegben.";
         else
             for (; it != sa.end(); ++it)
-                std::cout << it->c_str() << std::endl;
+                std::cout << it->c_str() << '\n';
+        std::cout.flush();
     }
     catch (std::exception& e) {
         std::cout << "Hiba tortent a program futasakozben." << std::endl;
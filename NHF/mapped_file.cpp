@@ -0,0 +1,91 @@
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <string>
+#include <stdexcept>
+
+#include "mapped_file.h"
+
+/**
+ * Csak olvasásra a memóriába képezi a fájlt.
+ * Hibát dob, ha a fájl nem nyitható meg vagy nem képezhetö le.
+ *
+ * @param utvonal A fájl elérési útja
+ */
+MappedFile::MappedFile(const char* utvonal) : adat(nullptr), meret(0) {
+#ifdef _WIN32
+    fajl = CreateFileA(utvonal, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fajl == INVALID_HANDLE_VALUE)
+        throw std::runtime_error(std::string("Nem nyithato meg: ") + utvonal);
+    LARGE_INTEGER hossz;
+    if (!GetFileSizeEx(fajl, &hossz) || hossz.QuadPart == 0) {
+        CloseHandle(fajl);
+        throw std::runtime_error(std::string("Ures vagy olvashatatlan fajl: ") + utvonal);
+    }
+    meret = (size_t)hossz.QuadPart;
+    lekepezes = CreateFileMappingA(fajl, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (lekepezes == NULL) {
+        CloseHandle(fajl);
+        throw std::runtime_error(std::string("Nem kepezheto le: ") + utvonal);
+    }
+    adat = static_cast<const char*>(MapViewOfFile(lekepezes, FILE_MAP_READ, 0, 0, 0));
+    if (adat == nullptr) {
+        CloseHandle(lekepezes);
+        CloseHandle(fajl);
+        throw std::runtime_error(std::string("Nem kepezheto le: ") + utvonal);
+    }
+#else
+    fajl = ::open(utvonal, O_RDONLY);
+    if (fajl < 0)
+        throw std::runtime_error(std::string("Nem nyithato meg: ") + utvonal);
+    struct stat allapot;
+    if (fstat(fajl, &allapot) != 0 || allapot.st_size == 0) {
+        ::close(fajl);
+        throw std::runtime_error(std::string("Ures vagy olvashatatlan fajl: ") + utvonal);
+    }
+    meret = (size_t)allapot.st_size;
+    void* p = mmap(nullptr, meret, PROT_READ, MAP_SHARED, fajl, 0);
+    if (p == MAP_FAILED) {
+        ::close(fajl);
+        throw std::runtime_error(std::string("Nem kepezheto le: ") + utvonal);
+    }
+    adat = static_cast<const char*>(p);
+#endif
+}
+
+/**
+ * @return A leképezett fájl elsö bájtja
+ */
+const char* MappedFile::data() const {
+    return adat;
+}
+
+/**
+ * @return A leképezett fájl mérete bájtban
+ */
+size_t MappedFile::size() const {
+    return meret;
+}
+
+/**
+ * Destruktor.
+ * Megszünteti a leképezést és bezárja a fájlt.
+ */
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    UnmapViewOfFile(adat);
+    CloseHandle(lekepezes);
+    CloseHandle(fajl);
+#else
+    munmap(const_cast<char*>(adat), meret);
+    ::close(fajl);
+#endif
+}
\ No newline at end of file
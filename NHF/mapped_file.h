@@ -0,0 +1,26 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "memtrace.h"
+
+#include <iostream>
+
+class MappedFile {
+    const char* adat;
+    size_t meret;
+#ifdef _WIN32
+    void* fajl;
+    void* lekepezes;
+#else
+    int fajl;
+#endif
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+public:
+    MappedFile(const char*);
+    const char* data() const;
+    size_t size() const;
+    ~MappedFile();
+};
+
+#endif // !MAPPED_FILE_H
\ No newline at end of file
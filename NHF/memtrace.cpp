@@ -22,6 +22,33 @@ typo:       2019.
 #include <time.h>
 #include <ctype.h>
 
+#ifdef __cplusplus
+	/* szalbiztossag: sharded zarak, atomikus szamlalok */
+	#include <mutex>
+	#include <atomic>
+	#include <chrono>
+	typedef std::mutex mt_mutex;
+	#define MT_GUARD(m) std::lock_guard<std::mutex> mt_guard(m)
+	#define MT_LOCK(m) (m).lock()
+	#define MT_UNLOCK(m) (m).unlock()
+	#define MT_ATOMIC(T) std::atomic<T>
+	#define MT_LOAD(a) (a).load(std::memory_order_relaxed)
+	#define MT_ADD(a, d) (a).fetch_add(d, std::memory_order_relaxed)
+	#define MT_SUB(a, d) (a).fetch_sub(d, std::memory_order_relaxed)
+	#define MT_THREAD_LOCAL thread_local
+#else
+	/* C forditaskor egyszalu: a zarak uresek, a szamlalok egyszeru valtozok */
+	typedef int mt_mutex;
+	#define MT_GUARD(m) (void)(m)
+	#define MT_LOCK(m) (void)(m)
+	#define MT_UNLOCK(m) (void)(m)
+	#define MT_ATOMIC(T) T
+	#define MT_LOAD(a) (a)
+	#define MT_ADD(a, d) ((a) += (d))
+	#define MT_SUB(a, d) ((a) -= (d))
+	#define MT_THREAD_LOCAL
+#endif
+
 #ifdef MEMTRACE
 #define FROM_MEMTRACE_CPP
 #include "memtrace.h"
@@ -67,6 +94,17 @@ START_NAMESPACE
 		return s2;
 	}
 
+#ifdef MEMTRACE_SAMPLING
+	/* a szovegek a makrok literaljai, igy masolas nelkul, a fordito altal internalva tarolhatok */
+	static char *StrCpy(char ** to, const char * from) {
+		*to = (char*)from;
+		return *to;
+	}
+
+	static void StrFree(char * s) {
+		(void)s;
+	}
+#else
 	static char *StrCpy(char ** to, const char * from) {
         	if(from == NULL) {
 			*to = NULL;
@@ -77,6 +115,11 @@ START_NAMESPACE
         	return *to;
 	}
 
+	static void StrFree(char * s) {
+		if(s) free(s);
+	}
+#endif
+
 	static void *canary_malloc(size_t size, unsigned char data) {
 		char *p = (char *)malloc(size+2*CANARY_LEN);
 		if (p) {
@@ -182,6 +225,203 @@ START_NAMESPACE
 	static void initialize();
 END_NAMESPACE
 
+/*******************************************************************/
+/* MEMTRACE_PROFILE */
+/*******************************************************************/
+
+#ifdef MEMTRACE_PROFILE
+START_NAMESPACE
+	#define HIST_LEN 33      /* meret hisztogram: 0, 1, 2-3, 4-7, ... bajt */
+	#define TIMELINE_LEN 256 /* az elo bajtok idosoranak mintai */
+	#define TICK_EVERY 64    /* szalankent ennyi esemenyenkent kerul minta az idosorba */
+
+	typedef struct _callsite {
+		int f;
+		int line;
+		char * file;
+		size_t count;  /* foglalasok szama */
+		size_t bytes;  /* osszes foglalt bajt */
+		size_t live;   /* jelenleg elo bajtok */
+		size_t peak;   /* elo bajtok csucsa */
+		size_t hist[HIST_LEN];
+	} callsite;
+
+	/* egy shard profilja: a hivasi helyek nyilt cimzesu hash tablaja es osszesitoi. A shard zarja
+	   vedi, igy a foglalasok nem varnak egy kozos zarra; a riport fesuli ossze a shardokat.
+	   A rekordok kulon foglaltak, hogy a registry elemei novekedeskor is rajuk mutathassanak */
+	typedef struct {
+		callsite ** sites;
+		size_t sites_cap, sites_cnt;
+		size_t total_count, total_bytes;
+	} profile_t;
+
+	/* a profil kiirasa es a rekordok felszabaditasa utan nem gyujtunk; minden shard zarja alatt irjuk */
+	static BOOL profile_done;
+	/* az elo bajtok szama es az utolso minta ota mert csucsa: csak ez a ketto kozos minden shardnak */
+	static MT_ATOMIC(size_t) live_bytes;
+	static MT_ATOMIC(size_t) window_peak;
+	static MT_THREAD_LOCAL unsigned int tick_left;
+	/* az idosort es a csucsot a mintavetel zarja vedi; a shard zarak utan szabad csak venni */
+	static mt_mutex timeline_lock;
+	static size_t peak_bytes, last_live;
+	#ifdef __cplusplus
+		static std::chrono::steady_clock::time_point profile_start;
+	#else
+		static clock_t profile_start;
+	#endif
+	/* idosor: mintankent az adott idoszak csucsa. Ha betelik, a szomszedos
+	   mintakat osszevonjuk es a lepest duplazzuk, igy tetszoleges hosszu futast lefed */
+	static size_t timeline[TIMELINE_LEN];
+	static size_t timeline_len;
+	static double timeline_step = 0.01; /* masodperc */
+
+	static size_t site_hash(int f, int line, const char * file) {
+		size_t h = (size_t)line * 31 + (size_t)f;
+		if (file)
+			for (; *file; file++) h = h * 131 + (unsigned char)*file;
+		return h * (size_t)0x9E3779B97F4A7C15ULL;
+	}
+
+	static BOOL site_eq(callsite * c, int f, int line, const char * file) {
+		if (c->f != f || c->line != line) return FALSE;
+		if (c->file == NULL || file == NULL) return c->file == file ? TRUE : FALSE;
+		return strcmp(c->file, file) == 0 ? TRUE : FALSE;
+	}
+
+	/* a hivasi hely rekordja a profilban, ha meg nincs, letrehozza */
+	static callsite * find_site(profile_t * pr, call_t call) {
+		size_t i;
+		if ((pr->sites_cnt+1)*2 > pr->sites_cap) {
+			size_t old_cap = pr->sites_cap, new_cap = old_cap ? 2*old_cap : 256, j;
+			callsite ** n = (callsite**)calloc(new_cap, sizeof(callsite*));
+			if (n == NULL) return NULL;
+			for (j = 0; j < old_cap; j++) {
+				callsite * c = pr->sites[j];
+				if (c == NULL) continue;
+				i = site_hash(c->f, c->line, c->file) & (new_cap - 1);
+				while (n[i]) i = (i + 1) & (new_cap - 1);
+				n[i] = c;
+			}
+			free(pr->sites);
+			pr->sites = n;
+			pr->sites_cap = new_cap;
+		}
+		i = site_hash(call.f, call.line, call.file) & (pr->sites_cap - 1);
+		while (pr->sites[i] && !site_eq(pr->sites[i], call.f, call.line, call.file))
+			i = (i + 1) & (pr->sites_cap - 1);
+		if (pr->sites[i] == NULL) {
+			callsite * c = (callsite*)calloc(1, sizeof(callsite));
+			if (c == NULL) return NULL;
+			c->f = call.f;
+			c->line = call.line;
+			StrCpy(&c->file, call.file);
+			pr->sites[i] = c;
+			pr->sites_cnt++;
+		}
+		return pr->sites[i];
+	}
+
+	/* felszabaditja a profil rekordjait a lemasolt fajlnevekkel egyutt */
+	static void free_sites(profile_t * pr) {
+		size_t i;
+		for (i = 0; i < pr->sites_cap; i++) {
+			if (pr->sites[i] == NULL) continue;
+			StrFree(pr->sites[i]->file);
+			free(pr->sites[i]);
+		}
+		free(pr->sites);
+		pr->sites = NULL;
+		pr->sites_cap = pr->sites_cnt = 0;
+	}
+
+	/* a profilozas kezdete ota eltelt ido masodpercben */
+	static double profile_elapsed(void) {
+		#ifdef __cplusplus
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - profile_start).count();
+		#else
+			return (double)(clock() - profile_start) / CLOCKS_PER_SEC;
+		#endif
+	}
+
+	/* az elo bajtok noveles utani erteke; emeli az idoszak csucsat */
+	static void raise_peak(size_t now) {
+		#ifdef __cplusplus
+			size_t cur = window_peak.load(std::memory_order_relaxed);
+			while (now > cur && !window_peak.compare_exchange_weak(cur, now, std::memory_order_relaxed));
+		#else
+			if (now > window_peak) window_peak = now;
+		#endif
+	}
+
+	/* minta az idosorba: az elozo minta ota mert csucs az aktualis idoszakhoz kerul.
+	   Csak itt olvassuk az orat, igy a foglalasok tobbsege nem fizet erte */
+	static void profile_tick(void) {
+		MT_GUARD(timeline_lock);
+		double t = profile_elapsed();
+		size_t live = MT_LOAD(live_bytes), peak, idx, i;
+		#ifdef __cplusplus
+			peak = window_peak.exchange(live, std::memory_order_relaxed);
+		#else
+			peak = window_peak;
+			window_peak = live;
+		#endif
+		if (live > peak) peak = live;
+		if (peak > peak_bytes) peak_bytes = peak;
+		idx = (size_t)(t / timeline_step);
+		while (idx >= TIMELINE_LEN) {
+			for (i = 0; i < TIMELINE_LEN/2; i++)
+				timeline[i] = timeline[2*i] > timeline[2*i+1] ? timeline[2*i] : timeline[2*i+1];
+			memset(timeline + TIMELINE_LEN/2, 0, TIMELINE_LEN/2*sizeof(size_t));
+			timeline_len = (timeline_len + 1) / 2;
+			timeline_step *= 2;
+			idx = (size_t)(t / timeline_step);
+		}
+		/* a minta nelkuli idoszakokban az elozo mintakor elo ertek maradt */
+		while (timeline_len <= idx) timeline[timeline_len++] = last_live;
+		if (peak > timeline[idx]) timeline[idx] = peak;
+		last_live = live;
+	}
+
+	/* szalankent minden TICK_EVERY. esemeny, es minden szal elso esemenye mintat vesz */
+	static void profile_event(void) {
+		if (tick_left == 0) {
+			tick_left = TICK_EVERY;
+			profile_tick();
+		}
+		tick_left--;
+	}
+
+	/* a foglalas shardjanak zarja alatt hivando */
+	static callsite * profile_alloc(profile_t * pr, call_t call, size_t size) {
+		callsite * c;
+		size_t b = 0;
+		if (profile_done) return NULL;
+		c = find_site(pr, call);
+		if (c == NULL) return NULL;
+		while (b < HIST_LEN-1 && (size >> b) != 0) b++;
+		c->count++;
+		c->bytes += size;
+		c->live += size;
+		if (c->live > c->peak) c->peak = c->live;
+		c->hist[b]++;
+		pr->total_count++;
+		pr->total_bytes += size;
+		MT_ADD(live_bytes, size);
+		raise_peak(MT_LOAD(live_bytes));
+		profile_event();
+		return c;
+	}
+
+	/* a blokk shardjanak zarja alatt hivando */
+	static void profile_free(callsite * c, size_t size) {
+		if (profile_done || c == NULL) return;
+		c->live -= size;
+		MT_SUB(live_bytes, size);
+		profile_event();
+	}
+END_NAMESPACE
+#endif/*MEMTRACE_PROFILE*/
+
 /*******************************************************************/
 /* MEMTRACE_TO_MEMORY */
 /*******************************************************************/
@@ -189,23 +429,112 @@ END_NAMESPACE
 #ifdef MEMTRACE_TO_MEMORY
 START_NAMESPACE
 	typedef struct _registry_item {
-		void * p;    /* mem pointer*/
+		void * p;    /* mem pointer, NULL: ures rekesz */
 		size_t size; /* size*/
+		size_t seq;  /* foglalas sorszama, a szivargasok sorrendjehez */
 		call_t call;
-		struct _registry_item * next;
+		#ifdef MEMTRACE_PROFILE
+			callsite * site;
+		#endif
 	} registry_item;
 
-	static registry_item registry; /*sentinel*/
+	/* nyilt cimzesu hash tablak linearis probalassal, kulcs a mem pointer.
+	   A pointer hash-e szerint SHARDS kulon zarral vedett reszre oszlik, igy a kulonbozo
+	   szalak foglalasai altalaban nem varnak egymasra. */
+	#define SHARD_BITS 6
+	#define SHARDS (1 << SHARD_BITS)
+	typedef struct {
+		registry_item * items;
+		size_t cap;  /* rekeszek szama, 2 hatvanya */
+		size_t cnt;  /* foglalt rekeszek szama */
+		mt_mutex lock;
+		#ifdef MEMTRACE_PROFILE
+			profile_t prof;  /* a shard blokkjainak profilja */
+		#endif
+	} shard_t;
 
-	static void print_registry_item(registry_item * p) {
-		if (p) {
-			print_registry_item(p->next);
-			fprintf(fperror, "\t%p%5d byte ",p->p, (int)p->size);
-			print_call(NULL, p->call);
-			if(p->call.par_txt) free(p->call.par_txt);
-			if(p->call.file) free(p->call.file);
-			free(p);
+	static shard_t shards[SHARDS];
+	static MT_ATOMIC(size_t) registry_seq;
+
+	static size_t hash_ptr(void * p) {
+		size_t h = (size_t)p >> 4;
+		h ^= h >> 16;
+		h *= (size_t)0x9E3779B97F4A7C15ULL;
+		h ^= h >> 29;
+		return h;
+	}
+
+	static shard_t * shard_of(void * p) {
+		return &shards[hash_ptr(p) & (SHARDS - 1)];
+	}
+
+	static size_t home_slot(shard_t * s, void * p) {
+		return (hash_ptr(p) >> SHARD_BITS) & (s->cap - 1);
+	}
+
+	/* p rekesze, vagy ha nincs a tablaban, az ures rekesz, ahova kerulne */
+	static registry_item * find_slot(shard_t * s, void * p) {
+		size_t i = home_slot(s, p);
+		while (s->items[i].p != NULL && s->items[i].p != p)
+			i = (i + 1) & (s->cap - 1);
+		return &s->items[i];
+	}
+
+	static BOOL registry_grow(shard_t * s) {
+		size_t old_cap = s->cap, new_cap = old_cap ? 2*old_cap : 64, i;
+		registry_item * old = s->items;
+		registry_item * n = (registry_item*)calloc(new_cap, sizeof(registry_item));
+		if(n==NULL) return FALSE;
+		s->items = n;
+		s->cap = new_cap;
+		for (i = 0; i < old_cap; i++)
+			if (old[i].p) *find_slot(s, old[i].p) = old[i];
+		free(old);
+		return TRUE;
+	}
+
+	/* torles visszafele tolassal, hogy ne szakadjanak meg a probalasi lancok */
+	static void registry_remove(shard_t * s, registry_item * r) {
+		size_t i = (size_t)(r - s->items), j = i, k;
+		s->cnt--;
+		for (;;) {
+			j = (j + 1) & (s->cap - 1);
+			if (s->items[j].p == NULL) break;
+			k = home_slot(s, s->items[j].p);
+			/* marad, ha a helye ciklikusan (i, j] koze esik */
+			if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+			s->items[i] = s->items[j];
+			i = j;
 		}
+		s->items[i].p = NULL;
+	}
+
+	/* a shard zarjat a hivonak kell tartania */
+	static registry_item *find_registry_item(shard_t * s, void * p) {
+		registry_item *n;
+		if (s->cap == 0) return NULL;
+		n = find_slot(s, p);
+		return n->p ? n : NULL;
+	}
+
+	static size_t registered_size(void * p) {
+		shard_t * s = shard_of(p);
+		MT_GUARD(s->lock);
+		registry_item * n = find_registry_item(s, p);
+		return n ? n->size : 0;
+	}
+
+	static int cmp_seq(const void * a, const void * b) {
+		size_t x = (*(registry_item * const *)a)->seq;
+		size_t y = (*(registry_item * const *)b)->seq;
+		return x < y ? -1 : x > y;
+	}
+
+	static void print_registry_item(registry_item * p) {
+		fprintf(fperror, "\t%p%5d byte ",p->p, (int)p->size);
+		print_call(NULL, p->call);
+		StrFree(p->call.par_txt);
+		StrFree(p->call.file);
 	}
 
 	/* ha nincs hiba, akkor 0-val tér vissza */
@@ -213,21 +542,148 @@ START_NAMESPACE
 		initialize();
 		if(dying) return  2;    /* címzési hiba */
 
-		if(registry.next) {
-			/*szivarog*/
-		    #ifdef MEMTRACE_ERRFILE
-                fperror = fopen(XSTR(MEMTRACE_ERRFILE), "w");
-            #endif
-			fprintf(fperror, "Szivargas:\n");
-			print_registry_item(registry.next);
-			registry.next = NULL;
-			return 1;           /* memória fogyás */
-		}
+		{/*C-blokk*/
+			size_t i, k, cnt = 0;
+			/* a tablak csak a zarak alatt olvashatok, mindet egyszerre zaroljuk */
+			for (k = 0; k < SHARDS; k++) {
+				MT_LOCK(shards[k].lock);
+				cnt += shards[k].cnt;
+			}
+			if(cnt) {
+				/*szivarog*/
+			    #ifdef MEMTRACE_ERRFILE
+	                fperror = fopen(XSTR(MEMTRACE_ERRFILE), "w");
+	            #endif
+				fprintf(fperror, "Szivargas:\n");
+				/* foglalasi sorrendben irjuk ki, ahogy a lancolt lista tette */
+				registry_item ** list = (registry_item**)malloc(cnt*sizeof(registry_item*));
+				size_t db = 0;
+				for (k = 0; k < SHARDS; k++) {
+					for (i = 0; i < shards[k].cap; i++) {
+						if (shards[k].items[i].p == NULL) continue;
+						if (list) list[db++] = &shards[k].items[i];
+						else print_registry_item(&shards[k].items[i]);
+					}
+				}
+				if (list) {
+					qsort(list, db, sizeof(registry_item*), cmp_seq);
+					for (i = 0; i < db; i++)
+						print_registry_item(list[i]);
+					free(list);
+				}
+				for (k = 0; k < SHARDS; k++) {
+					if (shards[k].items) memset(shards[k].items, 0, shards[k].cap*sizeof(registry_item));
+					shards[k].cnt = 0;
+				}
+			}
+			for (k = 0; k < SHARDS; k++)
+				MT_UNLOCK(shards[k].lock);
+			if(cnt) return 1;   /* memória fogyás */
+		}/*C-blokk*/
         return 0;
 	}
 END_NAMESPACE
 #endif/*MEMTRACE_TO_MEMORY*/
 
+/*******************************************************************/
+/* MEMTRACE_PROFILE riport */
+/*******************************************************************/
+
+#ifdef MEMTRACE_PROFILE
+START_NAMESPACE
+	static int cmp_bytes(const void * a, const void * b) {
+		size_t x = (*(callsite * const *)a)->bytes;
+		size_t y = (*(callsite * const *)b)->bytes;
+		return x > y ? -1 : x < y;
+	}
+
+	/* kiirja a profilt, a hivasi helyeket az osszes foglalt bajt szerint csokkeno sorrendben.
+	   A shardok azonos hivasi helyeit osszefesuli; egy hely csucsa a shardonkenti csucsok osszege
+	   (legfeljebb a teljes csucs), ami felso becsles, ha a hely blokkjai tobb shardba kerultek */
+	void mem_profile(FILE * fp) {
+		profile_t osszes = { NULL, 0, 0, 0, 0 };
+		callsite ** list;
+		size_t i, j, k, db = 0;
+		for (k = 0; k < SHARDS; k++)
+			MT_LOCK(shards[k].lock);
+		if (!profile_done) profile_tick();
+		for (k = 0; k < SHARDS; k++) {
+			profile_t * pr = &shards[k].prof;
+			osszes.total_count += pr->total_count;
+			osszes.total_bytes += pr->total_bytes;
+			for (i = 0; i < pr->sites_cap; i++) {
+				callsite * c = pr->sites[i], * m;
+				call_t key;
+				if (c == NULL) continue;
+				/* pack() lemasolna a szovegeket, itt csak kulcskent kell */
+				key.f = c->f;
+				key.line = c->line;
+				key.par_txt = NULL;
+				key.file = c->file;
+				m = find_site(&osszes, key);
+				if (m == NULL) continue;
+				m->count += c->count;
+				m->bytes += c->bytes;
+				m->live += c->live;
+				m->peak += c->peak;
+				for (j = 0; j < HIST_LEN; j++) m->hist[j] += c->hist[j];
+			}
+		}
+		list = (callsite**)malloc((osszes.sites_cnt ? osszes.sites_cnt : 1)*sizeof(callsite*));
+		if (list) {
+			for (i = 0; i < osszes.sites_cap; i++)
+				if (osszes.sites[i]) list[db++] = osszes.sites[i];
+			qsort(list, db, sizeof(callsite*), cmp_bytes);
+			fprintf(fp, "Foglalasi profil: %llu foglalas, %llu byte, elo csucs: %llu byte, most elo: %llu byte\n",
+				(unsigned long long)osszes.total_count, (unsigned long long)osszes.total_bytes,
+				(unsigned long long)peak_bytes, (unsigned long long)MT_LOAD(live_bytes));
+			fprintf(fp, "%12s %14s %14s %14s  %s\n", "darab", "byte", "elo csucs<=", "elo", "hely / meret hisztogram");
+			for (i = 0; i < db; i++) {
+				callsite * c = list[i];
+				fprintf(fp, "%12llu %14llu %14llu %14llu  %s @ %s:%d\n\t",
+					(unsigned long long)c->count, (unsigned long long)c->bytes,
+					(unsigned long long)(c->peak < peak_bytes ? c->peak : peak_bytes), (unsigned long long)c->live,
+					pretty[c->f], c->file ? basename(c->file) : "?", c->line);
+				for (j = 0; j < HIST_LEN; j++) {
+					if (c->hist[j] == 0) continue;
+					if (j == 0) fprintf(fp, " 0:");
+					else fprintf(fp, " %llu-%llu:", 1ULL << (j-1), (1ULL << j) - 1);
+					fprintf(fp, "%llu", (unsigned long long)c->hist[j]);
+				}
+				fprintf(fp, "\n");
+			}
+			fprintf(fp, "Elo byte csucs idoben (lepes: %g s):\n", timeline_step);
+			for (i = 0; i < timeline_len; i++)
+				fprintf(fp, "%10.3f %14llu\n", i*timeline_step, (unsigned long long)timeline[i]);
+			free(list);
+		}
+		free_sites(&osszes);
+		for (k = 0; k < SHARDS; k++)
+			MT_UNLOCK(shards[k].lock);
+	}
+
+	static void profile_at_exit(void) {
+		FILE * fp;
+		size_t k;
+		/* die() a hibat okozo shard zarjat tartva hiv exit-et, a zarak most nem szerezhetok meg */
+		if (dying) return;
+		fp = fopen("memtrace.profile", "w");
+		if (fp) {
+			mem_profile(fp);
+			fclose(fp);
+		}
+		/* a meg elo blokkok is a rekordokra mutatnak, ezert elobb leallitjuk a gyujtest */
+		for (k = 0; k < SHARDS; k++)
+			MT_LOCK(shards[k].lock);
+		profile_done = TRUE;
+		for (k = 0; k < SHARDS; k++)
+			free_sites(&shards[k].prof);
+		for (k = 0; k < SHARDS; k++)
+			MT_UNLOCK(shards[k].lock);
+	}
+END_NAMESPACE
+#endif/*MEMTRACE_PROFILE*/
+
 /*******************************************************************/
 /* MEMTRACE_TO_FILE */
 /*******************************************************************/
@@ -235,6 +691,7 @@ END_NAMESPACE
 #ifdef MEMTRACE_TO_FILE
 START_NAMESPACE
 	static FILE * trace_file;
+	static mt_mutex trace_lock;  /* egy sor egy darabban keruljon a fajlba */
 END_NAMESPACE
 #endif
 
@@ -242,8 +699,57 @@ END_NAMESPACE
 /* register/unregister */
 /*******************************************************************/
 
+#ifdef MEMTRACE_SAMPLING
+START_NAMESPACE
+	/* szalankent: ennyi foglalas/bajt van meg hatra a kovetkezo mintaig */
+	static MT_THREAD_LOCAL long long sample_left;
+	static MT_THREAD_LOCAL unsigned int sample_rng;
+
+	/* veletlen koz 1 es 2N kozott; fix kozzel az utemesen ismetlodo foglalasok torzitanak */
+	static long long next_interval(long long n) {
+		if (sample_rng == 0) sample_rng = (unsigned int)(size_t)&sample_left | 1;
+		sample_rng ^= sample_rng << 13;
+		sample_rng ^= sample_rng >> 17;
+		sample_rng ^= sample_rng << 5;
+		return 1 + (long long)(sample_rng % (unsigned long long)(2*n));
+	}
+
+	/* kovetni kell-e ezt a foglalast */
+	static BOOL sample_this(size_t size) {
+		#ifdef MEMTRACE_SAMPLE_EVERY
+			(void)size;
+			if (--sample_left > 0) return FALSE;
+			sample_left = next_interval(MEMTRACE_SAMPLE_EVERY);
+		#else
+			sample_left -= (long long)size;
+			if (sample_left > 0) return FALSE;
+			sample_left = next_interval(MEMTRACE_SAMPLE_BYTES);
+		#endif
+		return TRUE;
+	}
+
+	/* szamlalo szuro a kovetett blokkokrol: ha a pointer rekeszeben 0 all, a blokk biztosan
+	   nem kovetett, es zar nelkul felszabadithato */
+	#define FILTER_BITS 16
+	static MT_ATOMIC(unsigned int) sample_filter[1 << FILTER_BITS];
+
+	static size_t filter_slot(void * p) {
+		return (hash_ptr(p) >> (SHARD_BITS + 8)) & ((1 << FILTER_BITS) - 1);
+	}
+
+	/* p (mem pointer) kovetett blokk-e */
+	static BOOL is_traced(void * p) {
+		shard_t * s;
+		if (MT_LOAD(sample_filter[filter_slot(p)]) == 0) return FALSE;
+		s = shard_of(p);
+		MT_GUARD(s->lock);
+		return find_registry_item(s, p) ? TRUE : FALSE;
+	}
+END_NAMESPACE
+#endif/*MEMTRACE_SAMPLING*/
+
 START_NAMESPACE
-	static int allocated_blks;
+	static MT_ATOMIC(int) allocated_blks;
 
     int allocated_blocks() { return allocated_blks; }
 
@@ -251,49 +757,56 @@ START_NAMESPACE
 		initialize();
 		allocated_blks++;
 		#ifdef MEMTRACE_TO_FILE
+		{/*C-blokk*/
+			MT_GUARD(trace_lock);
 			fprintf(trace_file, "%p\t%d\t%s%s", PU(p), (int)size, pretty[call.f], call.par_txt ? call.par_txt : "?");
 			if (call.f <= 3) fprintf(trace_file, ")");
 			fprintf(trace_file, "\t%d\t%s\n", call.line, call.file ? call.file : "?");
 			fflush(trace_file);
+		}/*C-blokk*/
 		#endif
 		#ifdef MEMTRACE_TO_MEMORY
 		{/*C-blokk*/
-			registry_item * n = (registry_item*)malloc(sizeof(registry_item));
-			if(n==NULL) return FALSE;
+			shard_t * s = shard_of(p);
+			MT_GUARD(s->lock);
+			registry_item * n;
+			if((s->cnt+1)*4 > s->cap*3 && !registry_grow(s)) return FALSE;
+			n = find_slot(s, p);
 			n->p = p;
 			n->size = size;
+			n->seq = registry_seq++;
 			n->call = call;
-			n->next = registry.next;
-			registry.next = n;
+			#ifdef MEMTRACE_PROFILE
+				n->site = profile_alloc(&s->prof, call, size);
+			#endif
+			#ifdef MEMTRACE_SAMPLING
+				MT_ADD(sample_filter[filter_slot(p)], 1);
+			#endif
+			s->cnt++;
 		}/*C-blokk*/
 		#endif
 
 		return TRUE;
 	}
 
-	#ifdef MEMTRACE_TO_MEMORY
-	static registry_item *find_registry_item(void * p) {
-            	registry_item *n = &registry;
-            	for(; n->next && n->next->p != p ; n=n->next);
-            	return n;
-    	}
-    	#endif
-
 	static void unregister_memory(void * p, call_t call) {
 		initialize();
 		#ifdef MEMTRACE_TO_FILE
+		{/*C-blokk*/
+			MT_GUARD(trace_lock);
                         fprintf(trace_file, "%p\t%d\t%s%s", PU(p), -1, pretty[call.f], call.par_txt ? call.par_txt : "?");
                         if (call.f <= 3) fprintf(trace_file, ")");
 			fprintf(trace_file,"\t%d\t%s\n",call.line, call.file ? call.file : "?");
 			fflush(trace_file);
+		}/*C-blokk*/
 		#endif
 		#ifdef MEMTRACE_TO_MEMORY
 		{ /*C-blokk*/
-			registry_item * n = find_registry_item(p);
-			if(n->next) {
+			shard_t * s = shard_of(p);
+			MT_GUARD(s->lock);
+			registry_item * r = find_registry_item(s, p);
+			if(r) {
                 allocated_blks--;
-				registry_item * r = n->next;
-				n->next = r->next;
 				if(COMP(r->call.f,call.f)) {
                     int chk = chk_canary(r->p, r->size);
                     if (chk < 0)
@@ -301,13 +814,19 @@ START_NAMESPACE
                     if (chk > 0)
                         die("Blokk utan serult a memoria", r->p,r->size,&r->call,&call);
 					/*rendben van minden*/
-					if(call.par_txt) free(call.par_txt);
-					if(r->call.par_txt) free(r->call.par_txt);
-					if(call.file) free(call.file);
-					if(r->call.file) free(r->call.file);
+					StrFree(call.par_txt);
+					StrFree(r->call.par_txt);
+					StrFree(call.file);
+					StrFree(r->call.file);
 					memset(PU(r->p), 'f', r->size);
 					PU(r->p)[r->size-1] = 0;
-					free(r);
+					#ifdef MEMTRACE_PROFILE
+						profile_free(r->site, r->size);
+					#endif
+					#ifdef MEMTRACE_SAMPLING
+						MT_SUB(sample_filter[filter_slot(p)], 1);
+					#endif
+					registry_remove(s, r);
 				} else {
 					/*hibas felszabaditas*/
 					die("Hibas felszabaditas:",r->p,r->size,&r->call,&call);
@@ -329,6 +848,9 @@ START_NAMESPACE
 	void * traced_malloc(size_t size, const char * par_txt, int line, const char * file) {
 		void * p;
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			if (!sample_this(size)) return malloc(size);
+		#endif
 		p = canary_malloc(size, random_byte);
 		if (p) {
 			if(!register_memory(p,size,pack(FMALLOC,par_txt,line,file))) {
@@ -344,6 +866,9 @@ START_NAMESPACE
 		void * p;
 		initialize();
                 size *= count;
+		#ifdef MEMTRACE_SAMPLING
+			if (!sample_this(size)) return calloc(size, 1);
+		#endif
                 p = canary_malloc(size, 0);
 		if(p) {
 			if(!register_memory(p,size,pack(FCALLOC,par_txt,line,file))) {
@@ -358,14 +883,23 @@ START_NAMESPACE
 	void traced_free(void * pu, const char * par_txt, int line, const char * file) {
 		initialize();
 		if(pu) {
+			#ifdef MEMTRACE_SAMPLING
+				if (!is_traced(P(pu))) {
+					free(pu);
+					return;
+				}
+			#endif
 			unregister_memory(P(pu), pack(FFREE,par_txt,line,file));
 			free(P(pu));
 		} else {
 			/*free(NULL) eset*/
 			#ifdef MEMTRACE_TO_FILE
+			{/*C-blokk*/
+				MT_GUARD(trace_lock);
 				fprintf(trace_file,"%s\t%d\t%10s\t","NULL",-1,pretty[FFREE]);
 				fprintf(trace_file,"%d\t%s\n",line,file ? file : "?");
 				fflush(trace_file);
+			}/*C-blokk*/
 			#endif
 			#ifndef ALLOW_FREE_NULL
 			{/*C-blokk*/
@@ -380,12 +914,15 @@ START_NAMESPACE
 	void * traced_realloc(void * old, size_t size, const char * par_txt, int line, const char * file) {
 		void * p;
         size_t oldsize = 0;
-		registry_item * n;
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			/* nem kovetett blokk az is marad, uj blokknal mintavetelezunk */
+			if (old ? !is_traced(P(old)) : !sample_this(size))
+				return realloc(old, size);
+		#endif
 
 		#ifdef MEMTRACE_TO_MEMORY
-        		n = find_registry_item(P(old));
-        		if (n) oldsize = n->next->size;
+        		if (old) oldsize = registered_size(P(old));
 			p = canary_malloc(size, random_byte);
         	#else
         		p = realloc(old, size);
@@ -395,10 +932,8 @@ START_NAMESPACE
 			register_memory(p,size,pack(FREALLOC, par_txt, line,file));
             		if (old) {
 				#ifdef MEMTRACE_TO_MEMORY
-					int cpsize = 2*CANARY_LEN;
-                			if (oldsize < size) cpsize += oldsize;
-                			else cpsize += size;
-                			memcpy(p, P(old), cpsize);
+					/* csak a felhasznaloi adatot masoljuk, a kanarikat canary_malloc mar beallitotta */
+                			memcpy(PU(p), old, oldsize < size ? oldsize : size);
 				#endif
 		    			unregister_memory(P(old), pack(FREALLOC, par_txt, line, file));
 				#ifdef MEMTRACE_TO_MEMORY
@@ -427,11 +962,17 @@ START_NAMESPACE
 		_new_handler = h;
 	}
 
-	static call_t delete_call;
-	static BOOL delete_called;
+	/* a delete makro es a delete operator ugyanabban a szalban fut */
+	static MT_THREAD_LOCAL call_t delete_call;
+	static MT_THREAD_LOCAL BOOL delete_called;
 
 	void set_delete_call(int line, const char * file) {
 		initialize();
+		if(delete_called) {
+			/*az elozo delete NULL-ra szolt, es a fordito meg sem hivta az operatort: a szovegei gazdatlanok*/
+			StrFree(delete_call.par_txt);
+			StrFree(delete_call.file);
+		}
 		delete_call=pack(0,"",line,file); /*func értéke lényegtelen, majd felülírjuk*/
 		delete_called = TRUE;
 	}
@@ -439,11 +980,19 @@ START_NAMESPACE
 	void * traced_new(size_t size, int line, const char * file, int func) {
 		initialize();
 		for (;;) {
-			void * p = canary_malloc(size, random_byte);
-			if(p) {
-				register_memory(p,size,pack(func,"",line,file));
-				return PU(p);
-			}
+			#ifdef MEMTRACE_SAMPLING
+			if (!sample_this(size)) {
+				void * p = malloc(size ? size : 1);
+				if(p) return p;
+			} else
+			#endif
+			{/*C-blokk*/
+				void * p = canary_malloc(size, random_byte);
+				if(p) {
+					register_memory(p,size,pack(func,"",line,file));
+					return PU(p);
+				}
+			}/*C-blokk*/
 
 			if (_new_handler == 0)
 				throw std::bad_alloc();
@@ -454,11 +1003,21 @@ START_NAMESPACE
 
 	void traced_delete(void * pu, int func) {
 		initialize();
+		#ifdef MEMTRACE_SAMPLING
+			if(pu && !is_traced(P(pu))) {
+				free(pu);
+				pu = NULL;
+			}
+		#endif
 		if(pu) {
 			/*kiolvasom call-t, ha van*/
 			memtrace::call_t call = delete_called ? (delete_call.f=func, delete_call) : pack(func,NULL,0,NULL);
 			memtrace::unregister_memory(P(pu),call);
 			free(P(pu));
+		} else if(delete_called) {
+			/*NULL torlese: a delete makro altal lemasolt szovegeket senki sem veszi at*/
+			StrFree(delete_call.par_txt);
+			StrFree(delete_call.file);
 		}
 		delete_called=FALSE;
  	}
@@ -513,28 +1072,45 @@ void operator delete[](void * p, int, const char *) THROW_NOTHING {
 /*******************************************************************/
 
 START_NAMESPACE
-	static void initialize() {
-		static BOOL first = TRUE;
-		if(first) {
-            fperror = stderr;
-            random_byte = (unsigned char)time(NULL);
-			first = FALSE;
-			dying = FALSE;
-			#ifdef MEMTRACE_TO_MEMORY
-				registry.next = NULL;
-				#if !defined(USE_ATEXIT_OBJECT) && defined(MEMTRACE_AUTO)
-					atexit((void(*)(void))mem_check);
-				#endif
-			#endif
-			#ifdef MEMTRACE_TO_FILE
-				trace_file = fopen("memtrace.dump","w");
+	static void initialize_once(void) {
+        fperror = stderr;
+        random_byte = (unsigned char)time(NULL);
+		dying = FALSE;
+		#ifdef MEMTRACE_TO_MEMORY
+			#if !defined(USE_ATEXIT_OBJECT) && defined(MEMTRACE_AUTO)
+				atexit((void(*)(void))mem_check);
 			#endif
-			#ifdef MEMTRACE_CPP
-				_new_handler = NULL;
-				delete_called = FALSE;
-				delete_call = pack(0,NULL,0,NULL);
+			#ifdef MEMTRACE_PROFILE
+				#ifdef __cplusplus
+					profile_start = std::chrono::steady_clock::now();
+				#else
+					profile_start = clock();
+				#endif
+				atexit(profile_at_exit);
 			#endif
-		}
+		#endif
+		#ifdef MEMTRACE_TO_FILE
+			trace_file = fopen("memtrace.dump","w");
+		#endif
+		#ifdef MEMTRACE_CPP
+			_new_handler = NULL;
+		#endif
+	}
+
+	static void initialize() {
+	#ifdef __cplusplus
+		static std::once_flag first;
+		static std::atomic<bool> ready;
+		/* minden foglalaskor lefut, ezert a call_once ele gyors ellenorzes kerul */
+		if (ready.load(std::memory_order_acquire)) return;
+		std::call_once(first, initialize_once);
+		ready.store(true, std::memory_order_release);
+	#else
+		static BOOL ready;
+		if (ready) return;
+		ready = TRUE;
+		initialize_once();
+	#endif
 	}
 
 #if defined(MEMTRACE_TO_MEMORY) && defined(USE_ATEXIT_OBJECT)
@@ -23,6 +23,17 @@ inclue-ok:  2017., 2018., 2019., 2021.
 /*ekkor nincs ellenorzes, csak naplozas*/
 /*#define MEMTRACE_TO_FILE*/
 
+/*ha definialva van, akkor hivasi helyenkent osszesiti a foglalasokat (darab, bajt, meret hisztogram,
+  elo bajtok csucsa), es a megallaskor a memtrace.profile fajlba irja. MEMTRACE_TO_MEMORY kell hozza*/
+/*#define MEMTRACE_PROFILE*/
+
+/*ha definialva van, akkor atlagosan csak minden N. foglalast koveti (mintavetelezes), a tobbi
+  kanari, szovegmasolas es nyilvantartas nelkul megy at. Eles futtatashoz; MEMTRACE_TO_MEMORY kell hozza*/
+/*#define MEMTRACE_SAMPLE_EVERY 1000*/
+
+/*mint az elozo, de atlagosan N foglalt bajtonkent kovet egy foglalast, igy a nagy blokkokat gyakrabban*/
+/*#define MEMTRACE_SAMPLE_BYTES (512*1024)*/
+
 /*ha definialva van, akkor a megallaskor automatikus riport keszul */
 #define MEMTRACE_AUTO
 
@@ -56,6 +67,14 @@ inclue-ok:  2017., 2018., 2019., 2021.
 	#undef MEMTRACE_TO_MEMORY
 #endif
 
+#if defined(MEMTRACE_PROFILE) && !defined(MEMTRACE_TO_MEMORY)
+	#undef MEMTRACE_PROFILE
+#endif
+
+#if (defined(MEMTRACE_SAMPLE_EVERY) || defined(MEMTRACE_SAMPLE_BYTES)) && defined(MEMTRACE_TO_MEMORY)
+	#define MEMTRACE_SAMPLING
+#endif
+
 #ifndef MEMTRACE_AUTO
     #undef USE_ATEXIT_OBJECT
 #endif
@@ -105,6 +124,13 @@ START_NAMESPACE
 END_NAMESPACE
 #endif
 
+#if defined(MEMTRACE_PROFILE)
+#include <stdio.h>
+START_NAMESPACE
+	void mem_profile(FILE * fp);
+END_NAMESPACE
+#endif
+
 #if defined(MEMTRACE_TO_MEMORY) && defined(USE_ATEXIT_OBJECT)
 #include <cstdio>
 START_NAMESPACE
@@ -163,6 +189,10 @@ END_NAMESPACE
     #if __cplusplus >= 201103L
         #include <iterator>
         #include <regex>
+        #include <thread>  // deleted másoló konstruktorok
+        #include <mutex>
+        #include <condition_variable>
+        #include <atomic>
     #endif
 #endif
 #ifdef MEMTRACE_CPP
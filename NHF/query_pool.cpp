@@ -0,0 +1,164 @@
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+
+#include "query_pool.h"
+
+/**
+ * Konstruktor.
+ * Elindítja a munkás szálakat, amik a feladatokig alszanak.
+ *
+ * @param szalak A munkás szálak száma, 0 esetén a processzormagok száma
+ */
+QueryPool::QueryPool(unsigned szalak) : szal_db(szalak != 0 ? szalak : std::max(1u, std::thread::hardware_concurrency())), sorok(new Sor[szal_db]), leallit(szal_db, false), kor(0), feladat(nullptr), hatralevo(0) {
+    for (unsigned t = 0; t < szal_db; ++t)
+        sorok[t].eleje = sorok[t].vege = 0;
+    try {
+        munkasok.reserve(szal_db);
+        for (unsigned t = 0; t < szal_db; ++t)
+            munkasok.emplace_back(&QueryPool::munkas, this, t);
+    } catch (...) {
+        for (unsigned t = 0; t < munkasok.size(); ++t) {
+            {
+                std::lock_guard<std::mutex> lock(zar);
+                leallit[t] = true;
+            }
+            indul.notify_all();
+            munkasok[t].join();
+        }
+        delete[] sorok;
+        throw;
+    }
+}
+
+/**
+ * @return A munkás szálak száma
+ */
+unsigned QueryPool::size() const {
+    return szal_db;
+}
+
+/**
+ * Egy munkás szál ciklusa: megvárja a következö kört, majd addig dolgozik, amíg a saját
+ * sorában vagy a többiekében van feladat.
+ *
+ * @param id A munkás sorszáma
+ */
+void QueryPool::munkas(unsigned id) {
+    size_t latott = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(zar);
+            indul.wait(lock, [this, id, latott] { return leallit[id] || kor != latott; });
+            if (leallit[id])
+                return;
+            latott = kor;
+        }
+        size_t f;
+        while (kovetkezo(id, f)) {
+            (*feladat)(f, id);
+            if (--hatralevo == 0) {
+                std::lock_guard<std::mutex> lock(zar);
+                vegzett.notify_all();
+            }
+        }
+    }
+}
+
+/**
+ * Kivesz egy feladatot: elöször a saját sor végéröl, ha az üres, akkor egy másik sor elejéröl (work stealing).
+ * A saját sor végéröl vett feladatok egymás után következnek, a lopott feladat pedig a másik munkás
+ * által legkésöbb sorra kerülö rész, így a szálak ritkán versenyeznek ugyanazért a sorért.
+ *
+ * @param id A munkás sorszáma
+ * @param f Ide kerül a feladat sorszáma
+ * @return Volt-e még feladat
+ */
+bool QueryPool::kovetkezo(unsigned id, size_t& f) {
+    for (unsigned j = 0; j < szal_db; ++j) {
+        Sor& sor = sorok[(id + j) % szal_db];
+        std::lock_guard<std::mutex> lock(sor.zar);
+        if (sor.eleje < sor.vege) {
+            f = j == 0 ? --sor.vege : sor.eleje++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Lefuttatja a feladat(0..db-1) hívásokat a munkás szálakon, és megvárja, amíg mind végez.
+ * A feladatokat egyenlö, egybefüggö részekben osztja ki a munkások soraiba, a kifogyó munkások a többiektöl lopnak.
+ * A feladat második paramétere a végrehajtó munkás sorszáma, így szálanként elöre lefoglalt munkaterületet használhat.
+ * A feladatok nem dobhatnak kivételt.
+ *
+ * @param db A feladatok száma
+ * @param f A feladat
+ */
+void QueryPool::futtat(size_t db, const std::function<void(size_t, unsigned)>& f) {
+    if (db == 0)
+        return;
+    std::lock_guard<std::mutex> egyszerre_egy(hasznalat);
+    {
+        std::lock_guard<std::mutex> lock(zar);
+        feladat = &f;
+        hatralevo = db;
+    }
+    for (unsigned t = 0; t < szal_db; ++t) {
+        std::lock_guard<std::mutex> lock(sorok[t].zar);
+        sorok[t].eleje = (size_t)((unsigned long long)db * t / szal_db);
+        sorok[t].vege = (size_t)((unsigned long long)db * (t + 1) / szal_db);
+    }
+    std::unique_lock<std::mutex> lock(zar);
+    kor++;
+    indul.notify_all();
+    vegzett.wait(lock, [this] { return hatralevo == 0; });
+}
+
+/**
+ * Párhuzamos kötegelt keresés: a mintákat rendezi, a rendezett sorrendet darabokra vágja, és a darabokat
+ * a munkás szálak a SuffixArray::keres_batch algoritmusával dolgozzák fel.
+ * A SuffixArray-t közben senki nem módosíthatja. Egyszerre csak egy keresés fut a poolon, a többi megvárja.
+ *
+ * @param sa A SuffixArray, amiben keres
+ * @param mintak A keresett karaktersorozatok
+ * @return Mintánként a találatok tartománya, a minták sorrendjében
+ */
+std::vector<SuffixArray::range> QueryPool::keres(const SuffixArray& sa, const std::vector<std::string>& mintak) {
+    std::vector<SuffixArray::range> talalatok(mintak.size());
+    if (sa.length() == 0 || mintak.empty())
+        return talalatok;
+    std::vector<size_t> sorrend = SuffixArray::rendezett_sorrend(mintak);
+    size_t max_hossz = 0;
+    for (const std::string& minta : mintak)
+        max_hossz = std::max(max_hossz, minta.length());
+
+    // minden munkásnak saját verem; egy darab elég kicsi a lopáshoz, de elég nagy, hogy a közös prefixek számítsanak
+    std::vector<SuffixArray::Tartomany> veremek(szal_db * (max_hossz + 1));
+    size_t darab = std::max<size_t>(64, mintak.size() / (szal_db * 16));
+    size_t darab_db = (mintak.size() + darab - 1) / darab;
+    std::function<void(size_t, unsigned)> f = [&](size_t d, unsigned munkas_id) {
+        size_t tol = d * darab, ig = std::min(mintak.size(), tol + darab);
+        sa.keres_rendezett(mintak, sorrend.data() + tol, ig - tol, veremek.data() + munkas_id * (max_hossz + 1), talalatok.data());
+    };
+    futtat(darab_db, f);
+    return talalatok;
+}
+
+/**
+ * Destruktor.
+ * A munkás szálakat egyenként állítja le, így azok nem egyszerre lépnek ki.
+ */
+QueryPool::~QueryPool() {
+    for (unsigned t = 0; t < szal_db; ++t) {
+        {
+            std::lock_guard<std::mutex> lock(zar);
+            leallit[t] = true;
+        }
+        indul.notify_all();
+        munkasok[t].join();
+    }
+    delete[] sorok;
+}
\ No newline at end of file
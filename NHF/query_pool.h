@@ -0,0 +1,43 @@
+#ifndef QUERY_POOL_H
+#define QUERY_POOL_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+#include "memtrace.h"
+#include "suffix_array.h"
+
+class QueryPool {
+    struct Sor {
+        std::mutex zar;
+        size_t eleje, vege;
+    };
+    unsigned szal_db;
+    Sor* sorok;
+    std::vector<std::thread> munkasok;
+    std::vector<bool> leallit;
+    std::mutex zar;
+    std::mutex hasznalat;
+    std::condition_variable indul;
+    std::condition_variable vegzett;
+    size_t kor;
+    const std::function<void(size_t, unsigned)>* feladat;
+    std::atomic<size_t> hatralevo;
+    QueryPool(const QueryPool&);
+    QueryPool& operator=(const QueryPool&);
+    void munkas(unsigned);
+    bool kovetkezo(unsigned, size_t&);
+    void futtat(size_t, const std::function<void(size_t, unsigned)>&);
+public:
+    QueryPool(unsigned = 0);
+    unsigned size() const;
+    std::vector<SuffixArray::range> keres(const SuffixArray&, const std::vector<std::string>&);
+    ~QueryPool();
+};
+
+#endif // !QUERY_POOL_H
\ No newline at end of file
@@ -0,0 +1,243 @@
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define SIMD_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+
+#include "simd_compare.h"
+
+#if defined(SIMD_X86) && defined(__GNUC__)
+    #define AVX2_CEL __attribute__((target("avx2")))
+#else
+    #define AVX2_CEL
+#endif
+
+typedef size_t (*KozosPrefixFv)(const char*, const char*, size_t);
+
+/**
+ * Skalár változat: 8 bájtos szavakat hasonlít, és csak az eltérö szón belül lép bájtonként.
+ * Nem olvas n bájtnál többet egyik oldalon sem.
+ *
+ * @param a Az egyik sorozat
+ * @param b A másik sorozat
+ * @param n Ennyi bájtot hasonlít legfeljebb
+ * @return Az elsö eltérés indexe, vagy n, ha nincs eltérés
+ */
+static size_t kozos_prefix_skalar(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        if (x != y)
+            break;
+    }
+    while (i < n && a[i] == b[i])
+        i++;
+    return i;
+}
+
+#ifdef SIMD_X86
+/**
+ * Az elsö beállított bit indexe; a maszk nem lehet 0.
+ */
+static unsigned elso_bit(unsigned maszk) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, maszk);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(maszk);
+#endif
+}
+
+/**
+ * SSE2 változat: 16 bájtot hasonlít egyszerre, a maradékot a skalár változat intézi.
+ * Igazítatlan betöltést használ, és nem olvas a sorozatok végén túl.
+ *
+ * @param a Az egyik sorozat
+ * @param b A másik sorozat
+ * @param n Ennyi bájtot hasonlít legfeljebb
+ * @return Az elsö eltérés indexe, vagy n, ha nincs eltérés
+ */
+static size_t kozos_prefix_sse2(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        unsigned elter = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xFFFFu;
+        if (elter != 0)
+            return i + elso_bit(elter);
+    }
+    return i + kozos_prefix_skalar(a + i, b + i, n - i);
+}
+
+/**
+ * AVX2 változat: 32 bájtot hasonlít egyszerre, a maradékot az SSE2 változat intézi.
+ * Csak akkor hívható, ha a processzor és az operációs rendszer is támogatja az AVX2-t.
+ *
+ * @param a Az egyik sorozat
+ * @param b A másik sorozat
+ * @param n Ennyi bájtot hasonlít legfeljebb
+ * @return Az elsö eltérés indexe, vagy n, ha nincs eltérés
+ */
+AVX2_CEL static size_t kozos_prefix_avx2(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        unsigned elter = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+        if (elter != 0)
+            return i + elso_bit(elter);
+    }
+    // a maradékot nem VEX kódolású SSE2 utasítások nézik; felsö regiszterfelekkel ez drága állapotváltás lenne
+    _mm256_zeroupper();
+    return i + kozos_prefix_sse2(a + i, b + i, n - i);
+}
+
+/**
+ * Megnézi, hogy a processzor ismeri-e az AVX2 utasításokat, és az operációs rendszer menti-e a YMM regisztereket.
+ */
+static bool avx2_tamogatott() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // OSXSAVE és AVX bit, utána az XCR0-ban az XMM és YMM állapot
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+/**
+ * A futtató gépen elérhetö legjobb változat.
+ * x86-on az SSE2 mindig van (x64-en az alap része, a 32 bites fordítás is SSE2-re céloz), az AVX2-t futásidöben ellenörzi.
+ *
+ * @return A legjobb elérhetö szint
+ */
+SimdSzint simd_szint() {
+#ifdef SIMD_X86
+    static const SimdSzint szint = avx2_tamogatott() ? AVX2 : SSE2;
+    return szint;
+#else
+    return SKALAR;
+#endif
+}
+
+/**
+ * @return A szint neve, pl. a benchmark kimenetéhez
+ */
+const char* simd_nev(SimdSzint szint) {
+    switch (szint) {
+    case AVX2:
+        return "avx2";
+    case SSE2:
+        return "sse2";
+    default:
+        return "skalar";
+    }
+}
+
+/**
+ * A szinthez tartozó változat; ha a gép nem támogatja a kért szintet, a legjobb elérhetöt adja.
+ */
+static KozosPrefixFv valtozat(SimdSzint szint) {
+    szint = std::min(szint, simd_szint());
+#ifdef SIMD_X86
+    if (szint == AVX2)
+        return kozos_prefix_avx2;
+    if (szint == SSE2)
+        return kozos_prefix_sse2;
+#endif
+    return kozos_prefix_skalar;
+}
+
+static size_t elso_hivas(const char*, const char*, size_t);
+
+/**
+ * A kiválasztott változat. Kezdetben az elso_hivas, ami kiválasztja és beírja a legjobbat,
+ * így a további hívások egyetlen (x86-on sima) betöltés után közvetlenül a változatba ugranak.
+ */
+static std::atomic<KozosPrefixFv> valasztott(elso_hivas);
+
+static size_t elso_hivas(const char* a, const char* b, size_t n) {
+    KozosPrefixFv legjobb = valtozat(AVX2);
+    valasztott.store(legjobb, std::memory_order_relaxed);
+    return legjobb(a, b, n);
+}
+
+/**
+ * Megadja, hány bájtban egyezik a két sorozat eleje, a gépen elérhetö legszélesebb vektorokkal.
+ * Az elsö 8 bájtot helyben nézi meg, mert a keresésben és az LCP építésben az eltérés többnyire
+ * ennyin belül van, és ilyenkor a változat hívása többe kerülne, mint maga az összehasonlítás.
+ *
+ * @param a Az egyik sorozat
+ * @param b A másik sorozat
+ * @param n Ennyi bájtot hasonlít legfeljebb, egyik sorozatból sem olvas ennél többet
+ * @return Az elsö eltérés indexe, vagy n, ha nincs eltérés
+ */
+size_t kozos_prefix(const char* a, const char* b, size_t n) {
+    if (n < 8) {
+        size_t i = 0;
+        while (i < n && a[i] == b[i])
+            i++;
+        return i;
+    }
+    uint64_t x, y;
+    std::memcpy(&x, a, 8);
+    std::memcpy(&y, b, 8);
+    if (x != y) {
+        size_t i = 0;
+        while (a[i] == b[i])
+            i++;
+        return i;
+    }
+    return 8 + valasztott.load(std::memory_order_relaxed)(a + 8, b + 8, n - 8);
+}
+
+/**
+ * Mint a kozos_prefix, de a megadott szintü változattal (legfeljebb a gép által támogatottal).
+ * A tesztek és a benchmark összehasonlításához.
+ *
+ * @param a Az egyik sorozat
+ * @param b A másik sorozat
+ * @param n Ennyi bájtot hasonlít legfeljebb
+ * @param szint A használandó változat
+ * @return Az elsö eltérés indexe, vagy n, ha nincs eltérés
+ */
+size_t kozos_prefix(const char* a, const char* b, size_t n, SimdSzint szint) {
+    return valtozat(szint)(a, b, n);
+}
+
+/**
+ * Összehasonlítja a szöveg két suffixét bájtonként, elöjel nélkül, ahogy a SuffixArray rendez.
+ * A közös prefixet vektorosan lépi át, így a hosszú egyezö részeknél sem bájtonként halad.
+ *
+ * @param szoveg A szöveg
+ * @param n A szöveg hossza
+ * @param a Az egyik suffix kezdöpozíciója
+ * @param b A másik suffix kezdöpozíciója
+ * @return Az a-nál kezdödö suffix kisebb-e
+ */
+bool suffix_kisebb(const char* szoveg, size_t n, size_t a, size_t b) {
+    size_t la = n - a, lb = n - b;
+    size_t k = kozos_prefix(szoveg + a, szoveg + b, std::min(la, lb));
+    if (k == std::min(la, lb))
+        return la < lb;
+    return (unsigned char)szoveg[a + k] < (unsigned char)szoveg[b + k];
+}
\ No newline at end of file
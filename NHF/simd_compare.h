@@ -0,0 +1,16 @@
+#ifndef SIMD_COMPARE_H
+#define SIMD_COMPARE_H
+
+#include <cstddef>
+
+#include "memtrace.h"
+
+enum SimdSzint { SKALAR, SSE2, AVX2 };
+
+SimdSzint simd_szint();
+const char* simd_nev(SimdSzint);
+size_t kozos_prefix(const char*, const char*, size_t);
+size_t kozos_prefix(const char*, const char*, size_t, SimdSzint);
+bool suffix_kisebb(const char*, size_t, size_t, size_t);
+
+#endif // !SIMD_COMPARE_H
\ No newline at end of file
@@ -2,40 +2,167 @@
 #define SUFFIX_ARRAY_H
 
 #include "memtrace.h"
+#include "arena.h"
 
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <cstddef>
+#include <functional>
+
+class MappedFile;
 
 class SuffixArray {
+    friend class QueryPool;
+    friend class DocumentCollection;
+public:
+    enum Epites { SA_IS, RENDEZES, PARHUZAMOS };
+private:
     std::string szoveg;
-    std::string* suffix;
+    const char* szoveg_adat;
+    size_t szoveg_hossz;
+    size_t* suffix;
+    size_t* lcp_tomb;
+    MappedFile* lekepezes;
+    SuffixArray(MappedFile*, const char*, size_t, const size_t*, const size_t*);
+    void nezetFrissites();
+    void sajatMasolat();
+    void epit(Epites, unsigned);
     void rendez();
     void suffixGeneralas();
-    std::string leghosszabb_kozos_substr(const std::string&, size_t) const;
+    int hasonlit(size_t, const char*, size_t, size_t&) const;
+    size_t hatar(const char*, size_t, size_t, size_t, size_t, bool) const;
+    size_t ismetlodo_veg() const;
+    static std::string leghosszabb_kozos_substr(const char*, size_t, const char*, size_t);
 public:
+    class suffix_view {
+        const char* kezdet;
+        size_t hossz;
+    public:
+        suffix_view(const char* = "", size_t = 0);
+        const char* c_str() const;
+        size_t length() const;
+        char operator[](size_t) const;
+        std::string substr(size_t = 0, size_t = std::string::npos) const;
+        bool operator==(const std::string&) const;
+        bool operator!=(const std::string&) const;
+        operator std::string() const;
+    };
+
     struct iterator {
-        std::string* first;
-        std::string* last;
+        const size_t* first;
+        const size_t* last;
+        const char* szoveg;
+        size_t hossz;
+        suffix_view aktualis;
+        void frissit();
     public:
-        iterator(std::string* = nullptr, std::string* = nullptr);
+        iterator(const size_t* = nullptr, const size_t* = nullptr, const char* = nullptr, size_t = 0);
         iterator& operator++();
         iterator operator++(int);
         bool operator==(const iterator&) const;
         bool operator!=(const iterator&) const;
-        const std::string& operator*() const;
-        const std::string* operator->() const;
+        const suffix_view& operator*() const;
+        const suffix_view* operator->() const;
+    };
+
+    class range {
+        const size_t* first;
+        const size_t* last;
+        const char* szoveg;
+        size_t hossz;
+    public:
+        class const_iterator {
+            const size_t* akt;
+            const char* szoveg;
+            size_t hossz;
+        public:
+            typedef std::input_iterator_tag iterator_category;
+#ifdef __cpp_lib_ranges
+            typedef std::random_access_iterator_tag iterator_concept;
+#endif
+            typedef suffix_view value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef void pointer;
+            typedef suffix_view reference;
+            const_iterator(const size_t* = nullptr, const char* = nullptr, size_t = 0);
+            suffix_view operator*() const;
+            suffix_view operator[](difference_type) const;
+            size_t pozicio() const;
+            const_iterator& operator++();
+            const_iterator operator++(int);
+            const_iterator& operator--();
+            const_iterator operator--(int);
+            const_iterator& operator+=(difference_type);
+            const_iterator& operator-=(difference_type);
+            const_iterator operator+(difference_type) const;
+            const_iterator operator-(difference_type) const;
+            difference_type operator-(const const_iterator&) const;
+            bool operator==(const const_iterator&) const;
+            bool operator!=(const const_iterator&) const;
+            bool operator<(const const_iterator&) const;
+            bool operator>(const const_iterator&) const;
+            bool operator<=(const const_iterator&) const;
+            bool operator>=(const const_iterator&) const;
+            friend const_iterator operator+(difference_type, const const_iterator&);
+        };
+
+        range(const size_t* = nullptr, const size_t* = nullptr, const char* = nullptr, size_t = 0);
+        const_iterator begin() const;
+        const_iterator end() const;
+        size_t size() const;
+        bool empty() const;
+        suffix_view operator[](size_t) const;
+        size_t pozicio(size_t) const;
+        operator SuffixArray::iterator() const;
     };
 
-    SuffixArray(const char*);
-    SuffixArray(const std::string& str);
+private:
+    struct Tartomany {
+        size_t melyseg, eleje, vege;
+    };
+    range tartomany(const char*, size_t) const;
+    static std::vector<size_t> rendezett_sorrend(const std::vector<std::string>&);
+    void keres_rendezett(const std::vector<std::string>&, const size_t*, size_t, Tartomany*, range*) const;
+public:
+
+    SuffixArray(const char*, Epites = SA_IS, unsigned = 0);
+    SuffixArray(const std::string& str, Epites = SA_IS, unsigned = 0);
+    SuffixArray(std::string&& str, Epites = SA_IS, unsigned = 0);
     SuffixArray(const SuffixArray&);
+    SuffixArray(SuffixArray&&) noexcept;
+    static SuffixArray open(const char*, bool = false);
+    void save(const char*) const;
+    void lcpEpites();
+    bool vanLcp() const;
+    size_t lcp(size_t) const;
+    size_t operator[](size_t) const;
+    size_t length() const;
     const char* c_str() const;
     iterator keres(const char) const;
     iterator keres(const char*) const;
     iterator keres(const std::string&) const;
+    iterator keres(std::string_view) const;
+    range talalatok(const char) const;
+    range talalatok(const char*) const;
+    range talalatok(const std::string&) const;
+    range talalatok(std::string_view) const;
+    std::vector<range> keres_batch(const std::vector<std::string>&) const;
+    std::vector<size_t> locate(const char, bool = false) const;
+    std::vector<size_t> locate(const char*, bool = false) const;
+    std::vector<size_t> locate(const std::string&, bool = false) const;
+    ArenaVector<size_t> locate(const char, Arena&, bool = false) const;
+    ArenaVector<size_t> locate(const char*, Arena&, bool = false) const;
+    ArenaVector<size_t> locate(const std::string&, Arena&, bool = false) const;
+    void locate_each(const std::string&, const std::function<void(size_t)>&) const;
     iterator end() const;
     SuffixArray operator+(const SuffixArray&) const;
     SuffixArray& operator=(const SuffixArray&);
+    SuffixArray& operator=(SuffixArray&&) noexcept;
     SuffixArray& operator+=(const SuffixArray&);
+    SuffixArray& operator+=(const std::string&);
     std::string operator&(const SuffixArray&) const;
     ~SuffixArray();
 };